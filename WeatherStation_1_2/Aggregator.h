@@ -0,0 +1,119 @@
+/**
+ *  @file Aggregator.h
+ *  @brief Streaming min/max/mean/stddev per channel over cascaded time windows
+ *
+ *  Every sample updates one running Welford accumulator per channel (O(1), no history).
+ *  When the base window closes its statistics are merged into the longer windows,
+ *  which close after a fixed number of base windows (e.g. 1 min -> 10 min -> 1 h).
+ */
+#pragma once
+#include <stdint.h>
+#include <math.h>
+#include "Sample.h"
+
+enum AggChannel { AGG_TEMP, AGG_HUMID, AGG_PRESS, AGG_CHANNELS };
+
+/** ==========[ WELFORD ]========== **/
+struct Welford {
+    uint32_t n = 0;
+    float mean = 0.0f;
+    float m2 = 0.0f;                    // sum of squared deviations from the mean
+    float lo = 0.0f, hi = 0.0f;
+
+    void add(float x) {
+        n++;
+        if (n == 1) {
+            lo = hi = x;
+        } else {
+            if (x < lo) lo = x;
+            if (x > hi) hi = x;
+        }
+        float d = x - mean;
+        mean += d / n;
+        m2 += d * (x - mean);
+    }
+
+    /** Combine with another accumulator (Chan et al. parallel update) */
+    void merge(const Welford &o) {
+        if (o.n == 0) return;
+        if (n == 0) {
+            *this = o;
+            return;
+        }
+        uint32_t total = n + o.n;
+        float d = o.mean - mean;
+        mean += d * o.n / total;
+        m2 += o.m2 + d * d * ((float)n * o.n / total);
+        if (o.lo < lo) lo = o.lo;
+        if (o.hi > hi) hi = o.hi;
+        n = total;
+    }
+
+    float stddev() const { return n > 1 ? sqrtf(m2 / (n - 1)) : 0.0f; }
+};
+
+/** Statistics of one window */
+struct WindowStats {
+    uint32_t start;                     // epoch of the first sample [s]
+    Welford ch[AGG_CHANNELS];           // [C], [%RH], [hPa]
+
+    void reset(uint32_t t) {
+        start = t;
+        for (uint8_t c = 0; c < AGG_CHANNELS; c++) ch[c] = Welford();
+    }
+};
+
+/** ==========[ AGGREGATOR ]========== **/
+template <uint8_t LEVELS>
+class Aggregator {
+public:
+    /** @param baseMs    : length of the shortest window [ms]
+     *  @param multiples : length of each level in base windows (multiples[0] must be 1) */
+    Aggregator(uint32_t baseMs, const uint16_t (&multiples)[LEVELS]) : baseMs(baseMs) {
+        for (uint8_t l = 0; l < LEVELS; l++) mult[l] = multiples[l];
+    }
+
+    /** Add one sample
+     *  @param now : [ms]
+     *  @return bitmask of the levels that closed with this sample */
+    uint8_t add(const Sample &s, uint32_t now) {
+        if (!started) {
+            for (uint8_t l = 0; l < LEVELS; l++) open[l].reset(s.time);
+            baseStart = now;
+            started = true;
+        }
+        WindowStats &w = open[0];
+        w.ch[AGG_TEMP].add(sampleTempC(s));
+        w.ch[AGG_HUMID].add(sampleHumid(s));
+        w.ch[AGG_PRESS].add(sampleHPa(s));
+
+        if (now - baseStart < baseMs) return 0;
+        baseStart = now - baseStart >= 2 * baseMs ? now : baseStart + baseMs;
+
+        uint8_t closed = 1;
+        done[0] = open[0];
+        baseCount++;
+        for (uint8_t l = 1; l < LEVELS; l++) {
+            for (uint8_t c = 0; c < AGG_CHANNELS; c++) open[l].ch[c].merge(done[0].ch[c]);
+            if (baseCount % mult[l] == 0) {
+                done[l] = open[l];
+                open[l].reset(s.time);
+                closed |= 1 << l;
+            }
+        }
+        open[0].reset(s.time);
+        return closed;
+    }
+
+    /** Most recently closed window of a level */
+    const WindowStats &last(uint8_t level) const { return done[level]; }
+
+private:
+    uint32_t baseMs;
+    uint16_t mult[LEVELS];
+    uint32_t baseStart = 0;             // [ms]
+    uint32_t baseCount = 0;             // base windows closed so far
+    bool started = false;
+    WindowStats open[LEVELS];
+    WindowStats done[LEVELS] = {};
+};
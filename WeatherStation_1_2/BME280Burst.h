@@ -0,0 +1,298 @@
+/**
+ *  @file BME280Burst.h
+ *  @brief Single-burst BME280 acquisition -- one I2C read of 0xF7..0xFE per sample
+ *
+ *  The Adafruit readX() calls each run their own I2C transaction, and pressure and
+ *  humidity re-read temperature to get t_fine. Here the whole data block is read at once
+ *  and all three channels are compensated from one t_fine (Bosch datasheet, section 4.2.3).
+ *
+ *  bme280CompensateInt() is the datasheet's integer variant (32-bit T/H, 64-bit P) and
+ *  yields the fixed-point Sample channels directly, without any soft-float on FPU-less parts.
+ *
+ *  The primary sensor is set up (reset, oversampling, filter) through Adafruit_BME280;
+ *  additional ones can be set up without the library through reset() and configure().
+ */
+#pragma once
+#include <Wire.h>
+#include "I2CStats.h"
+
+#define BME280_REG_CALIB_TP 0x88        // dig_T1 .. dig_P9 (24 bytes)
+#define BME280_REG_CALIB_H1 0xA1
+#define BME280_REG_CALIB_H2 0xE1        // dig_H2 .. dig_H6 (7 bytes)
+#define BME280_REG_RESET 0xE0
+#define BME280_REG_CTRL_HUM 0xF2
+#define BME280_REG_STATUS 0xF3
+#define BME280_REG_CTRL_MEAS 0xF4
+#define BME280_REG_CONFIG 0xF5
+#define BME280_REG_DATA 0xF7            // press[3], temp[3], hum[2]
+
+/** ==========[ CALIBRATION ]========== **/
+struct BME280Calib {
+    uint16_t T1; int16_t T2, T3;
+    uint16_t P1; int16_t P2, P3, P4, P5, P6, P7, P8, P9;
+    uint8_t H1; int16_t H2; uint8_t H3; int16_t H4, H5; int8_t H6;
+};
+
+/** Raw ADC values of one burst read */
+struct BME280Raw {
+    int32_t adcT, adcP, adcH;
+};
+
+/** ==========[ PARSE ]========== **
+ *  Unpack the 8-byte data block starting at 0xF7
+ */
+inline BME280Raw bme280Parse(const uint8_t *d) {
+    BME280Raw r;
+    r.adcP = ((int32_t)d[0] << 12) | ((int32_t)d[1] << 4) | (d[2] >> 4);
+    r.adcT = ((int32_t)d[3] << 12) | ((int32_t)d[4] << 4) | (d[5] >> 4);
+    r.adcH = ((int32_t)d[6] << 8) | d[7];
+    return r;
+}
+
+/** ==========[ COMPENSATE ]========== **
+ *  Datasheet floating point formulas, all channels from a single t_fine
+ *  @param tempC      : [C]
+ *  @param humid      : [%RH]
+ *  @param pressurePa : [Pa]
+ */
+inline void bme280Compensate(const BME280Calib &c, const BME280Raw &r,
+                             float &tempC, float &humid, float &pressurePa) {
+    // Temperature
+    float v1 = (r.adcT / 16384.0f - c.T1 / 1024.0f) * c.T2;
+    float v2 = r.adcT / 131072.0f - c.T1 / 8192.0f;
+    v2 = v2 * v2 * c.T3;
+    float tFine = v1 + v2;
+    tempC = tFine / 5120.0f;
+
+    // Pressure
+    v1 = tFine / 2.0f - 64000.0f;
+    v2 = v1 * v1 * c.P6 / 32768.0f;
+    v2 = v2 + v1 * c.P5 * 2.0f;
+    v2 = v2 / 4.0f + c.P4 * 65536.0f;
+    v1 = (c.P3 * v1 * v1 / 524288.0f + c.P2 * v1) / 524288.0f;
+    v1 = (1.0f + v1 / 32768.0f) * c.P1;
+    if (v1 == 0.0f) {
+        pressurePa = 0.0f;      // avoid division by zero
+    } else {
+        float p = 1048576.0f - r.adcP;
+        p = (p - v2 / 4096.0f) * 6250.0f / v1;
+        v1 = c.P9 * p * p / 2147483648.0f;
+        v2 = p * c.P8 / 32768.0f;
+        pressurePa = p + (v1 + v2 + c.P7) / 16.0f;
+    }
+
+    // Humidity
+    float h = tFine - 76800.0f;
+    h = (r.adcH - (c.H4 * 64.0f + c.H5 / 16384.0f * h)) *
+        (c.H2 / 65536.0f * (1.0f + c.H6 / 67108864.0f * h * (1.0f + c.H3 / 67108864.0f * h)));
+    h = h * (1.0f - c.H1 * h / 524288.0f);
+    humid = h > 100.0f ? 100.0f : (h < 0.0f ? 0.0f : h);
+}
+
+/** ==========[ COMPENSATE INT ]========== **
+ *  Datasheet integer formulas (section 4.2.3 / 8.2), all channels from a single t_fine
+ *  @param temp       : [0.01 C]
+ *  @param humid      : [0.01 %RH]
+ *  @param pressurePa : [Pa], rounded
+ */
+inline void bme280CompensateInt(const BME280Calib &c, const BME280Raw &r,
+                                int16_t &temp, uint16_t &humid, uint32_t &pressurePa) {
+    // Temperature
+    int32_t v1 = ((((r.adcT >> 3) - ((int32_t)c.T1 << 1))) * (int32_t)c.T2) >> 11;
+    int32_t v2 = (((((r.adcT >> 4) - (int32_t)c.T1) * ((r.adcT >> 4) - (int32_t)c.T1)) >> 12) *
+                  (int32_t)c.T3) >> 14;
+    int32_t tFine = v1 + v2;
+    temp = (int16_t)((tFine * 5 + 128) >> 8);
+
+    // Pressure (Q24.8)
+    int64_t p1 = (int64_t)tFine - 128000;
+    int64_t p2 = p1 * p1 * (int64_t)c.P6;
+    p2 = p2 + ((p1 * (int64_t)c.P5) << 17);
+    p2 = p2 + ((int64_t)c.P4 << 35);
+    p1 = ((p1 * p1 * (int64_t)c.P3) >> 8) + ((p1 * (int64_t)c.P2) << 12);
+    p1 = ((((int64_t)1) << 47) + p1) * (int64_t)c.P1 >> 33;
+    if (p1 == 0) {
+        pressurePa = 0;         // avoid division by zero
+    } else {
+        int64_t p = 1048576 - r.adcP;
+        p = (((p << 31) - p2) * 3125) / p1;
+        p1 = ((int64_t)c.P9 * (p >> 13) * (p >> 13)) >> 25;
+        p2 = ((int64_t)c.P8 * p) >> 19;
+        p = ((p + p1 + p2) >> 8) + ((int64_t)c.P7 << 4);
+        pressurePa = (uint32_t)((p + 128) >> 8);
+    }
+
+    // Humidity (Q22.10)
+    int32_t h = tFine - 76800;
+    h = (((((r.adcH << 14) - ((int32_t)c.H4 << 20) - ((int32_t)c.H5 * h)) + 16384) >> 15) *
+         (((((((h * (int32_t)c.H6) >> 10) * (((h * (int32_t)c.H3) >> 11) + 32768)) >> 10) + 2097152) *
+           (int32_t)c.H2 + 8192) >> 14));
+    h = h - (((((h >> 15) * (h >> 15)) >> 7) * (int32_t)c.H1) >> 4);
+    h = h < 0 ? 0 : (h > 419430400 ? 419430400 : h);
+    humid = (uint16_t)((((uint32_t)h >> 12) * 100 + 512) >> 10);
+}
+
+
+/** ==========[ MEASUREMENT TIME ]========== **
+ *  Maximum duration of one forced conversion (datasheet appendix B, t_measure,max)
+ *  @param osrsT, osrsP, osrsH : oversampling 1 .. 16, 0 skips the channel
+ *  @return [us]
+ */
+constexpr uint32_t bme280MeasureMaxUs(uint8_t osrsT, uint8_t osrsP, uint8_t osrsH) {
+    return 1250 + 2300UL * osrsT + (osrsP ? 2300UL * osrsP + 575 : 0) + (osrsH ? 2300UL * osrsH + 575 : 0);
+}
+
+/** 0xF5 config value for an IIR coefficient: 0 (off), 2, 4, 8 or 16; t_sb 0 (unused in forced mode) */
+constexpr uint8_t bme280FilterConfig(uint8_t coeff) {
+    return (coeff >= 16 ? 4 : coeff >= 8 ? 3 : coeff >= 4 ? 2 : coeff >= 2 ? 1 : 0) << 2;
+}
+
+/** ==========[ BURST DRIVER ]========== **/
+class BME280Burst {
+public:
+    /** Read the trimming parameters and the oversampling set up by Adafruit_BME280::setSampling()
+     *  @param stats : Optional bus accounting for this device
+     *  @return false if the sensor did not answer */
+    bool begin(uint8_t addr, TwoWire &wire = Wire, I2CStats *stats = nullptr) {
+        this->addr = addr;
+        this->wire = &wire;
+        this->stats = stats;
+
+        uint8_t tp[24], h[7], ctrl;
+        if (!readRegs(BME280_REG_CALIB_TP, tp, sizeof(tp)) ||
+            !readRegs(BME280_REG_CALIB_H1, &calib.H1, 1) ||
+            !readRegs(BME280_REG_CALIB_H2, h, sizeof(h)) ||
+            !readRegs(BME280_REG_CTRL_MEAS, &ctrl, 1)) {
+            return false;
+        }
+        calib.T1 = (uint16_t)(tp[1] << 8 | tp[0]);
+        calib.T2 = (int16_t)(tp[3] << 8 | tp[2]);
+        calib.T3 = (int16_t)(tp[5] << 8 | tp[4]);
+        calib.P1 = (uint16_t)(tp[7] << 8 | tp[6]);
+        calib.P2 = (int16_t)(tp[9] << 8 | tp[8]);
+        calib.P3 = (int16_t)(tp[11] << 8 | tp[10]);
+        calib.P4 = (int16_t)(tp[13] << 8 | tp[12]);
+        calib.P5 = (int16_t)(tp[15] << 8 | tp[14]);
+        calib.P6 = (int16_t)(tp[17] << 8 | tp[16]);
+        calib.P7 = (int16_t)(tp[19] << 8 | tp[18]);
+        calib.P8 = (int16_t)(tp[21] << 8 | tp[20]);
+        calib.P9 = (int16_t)(tp[23] << 8 | tp[22]);
+        calib.H2 = (int16_t)(h[1] << 8 | h[0]);
+        calib.H3 = h[2];
+        calib.H4 = (int16_t)((int8_t)h[3] * 16 | (h[4] & 0x0F));
+        calib.H5 = (int16_t)((int8_t)h[5] * 16 | (h[4] >> 4));
+        calib.H6 = (int8_t)h[6];
+
+        osrs = ctrl & 0xFC;     // keep osrs_t / osrs_p, drop the mode bits
+        return true;
+    }
+
+    /** Soft reset; the chip reloads its trimming parameters within 2 ms
+     *  (call before begin(), which reads them) */
+    bool reset(uint8_t addr, TwoWire &wire = Wire, I2CStats *stats = nullptr) {
+        this->addr = addr;
+        this->wire = &wire;
+        this->stats = stats;
+        return writeReg(BME280_REG_RESET, 0xB6);
+    }
+
+    /** Set oversampling and filter directly, leaving the chip in sleep mode
+     *  @param ctrlHum  : 0xF2 value (osrs_h)
+     *  @param config   : 0xF5 value (t_sb, filter)
+     *  @param ctrlMeas : 0xF4 value (osrs_t, osrs_p; the mode bits are ignored) */
+    bool configure(uint8_t ctrlHum, uint8_t config, uint8_t ctrlMeas) {
+        osrs = ctrlMeas & 0xFC;
+        return writeReg(BME280_REG_CTRL_HUM, ctrlHum) &&       // ctrl_hum latches on the ctrl_meas write
+               writeReg(BME280_REG_CONFIG, config) &&
+               writeReg(BME280_REG_CTRL_MEAS, osrs);
+    }
+
+    /** Reuse trimming parameters read by an earlier begin(), e.g. kept in RTC memory
+     *  across deep sleep, without touching the bus */
+    void restore(uint8_t addr, const BME280Calib &calib, uint8_t osrs,
+                 TwoWire &wire = Wire, I2CStats *stats = nullptr) {
+        this->addr = addr;
+        this->wire = &wire;
+        this->stats = stats;
+        this->calib = calib;
+        this->osrs = osrs;
+    }
+
+    /** Start a forced-mode conversion; the sensor sleeps again once it is done */
+    bool trigger() {
+        return writeReg(BME280_REG_CTRL_MEAS, osrs | 0x01);
+    }
+
+    /** True while a conversion is running */
+    bool measuring() {
+        uint8_t status = 0;
+        return readRegs(BME280_REG_STATUS, &status, 1) && (status & 0x08);
+    }
+
+    /** Burst-read the data block and compensate it
+     *  @return false on a bus error or if a channel is still skipped after reset */
+    bool read(float &tempC, float &humid, float &pressurePa) {
+        uint8_t d[8];
+        if (!readRegs(BME280_REG_DATA, d, sizeof(d))) {
+            return false;
+        }
+        BME280Raw r = bme280Parse(d);
+        if (r.adcT == 0x80000 || r.adcP == 0x80000 || r.adcH == 0x8000) {
+            return false;       // no conversion has completed yet
+        }
+        bme280Compensate(calib, r, tempC, humid, pressurePa);
+        return true;
+    }
+
+    /** Burst-read the data block and compensate it in integer arithmetic
+     *  @param temp  : [0.01 C]
+     *  @param humid : [0.01 %RH]
+     *  @param pressurePa : [Pa]
+     *  @return false on a bus error or if a channel is still skipped after reset */
+    bool readInt(int16_t &temp, uint16_t &humid, uint32_t &pressurePa) {
+        uint8_t d[8];
+        if (!readRegs(BME280_REG_DATA, d, sizeof(d))) {
+            return false;
+        }
+        BME280Raw r = bme280Parse(d);
+        if (r.adcT == 0x80000 || r.adcP == 0x80000 || r.adcH == 0x8000) {
+            return false;       // no conversion has completed yet
+        }
+        bme280CompensateInt(calib, r, temp, humid, pressurePa);
+        return true;
+    }
+
+    const BME280Calib &calibration() const { return calib; }
+    uint8_t oversampling() const { return osrs; }
+
+private:
+    bool readRegs(uint8_t reg, uint8_t *buf, uint8_t len) {
+        uint32_t start = micros();
+        wire->beginTransmission(addr);
+        wire->write(reg);
+        bool ok = wire->endTransmission(false) == 0 && wire->requestFrom(addr, len) == len;
+        if (ok) {
+            for (uint8_t i = 0; i < len; i++) {
+                buf[i] = wire->read();
+            }
+        }
+        if (stats) stats->add(1 + len, micros() - start);
+        return ok;
+    }
+
+    bool writeReg(uint8_t reg, uint8_t val) {
+        uint32_t start = micros();
+        wire->beginTransmission(addr);
+        wire->write(reg);
+        wire->write(val);
+        bool ok = wire->endTransmission() == 0;
+        if (stats) stats->add(2, micros() - start);
+        return ok;
+    }
+
+    TwoWire *wire = nullptr;
+    I2CStats *stats = nullptr;
+    uint8_t addr = 0x76;
+    uint8_t osrs = 0;
+    BME280Calib calib = {};
+};
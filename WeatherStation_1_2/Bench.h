@@ -0,0 +1,81 @@
+/**
+ *  @file Bench.h
+ *  @brief Micro-benchmark runner -- per-call timings reported as ops/s and percentiles
+ *
+ *  Every iteration times `batch` back-to-back calls with micros(), so functions much
+ *  shorter than a microsecond still resolve. Timings go into one preallocated buffer
+ *  shared by all benchmarks, which is sorted for the percentiles after each run.
+ *  Used by the sketch's BENCH_MODE and by the host harness in host/.
+ */
+#pragma once
+#include <Arduino.h>
+#include <stdlib.h>
+
+#ifndef BENCH_MAX_SAMPLES
+#define BENCH_MAX_SAMPLES 2048          // Iterations kept per benchmark (4 bytes each)
+#endif
+
+struct BenchResult {
+    const char *name;
+    uint32_t n;                         // iterations timed
+    uint32_t batch;                     // calls per iteration
+    float opsPerSec;
+    float mean, p50, p90, p99, max;     // per call [us]
+};
+
+static uint32_t benchTicks[BENCH_MAX_SAMPLES];
+static volatile uint32_t benchSink;    // Benchmarked code stores results here so they are not optimised out
+
+inline int benchCompare(const void *a, const void *b) {
+    uint32_t x = *(const uint32_t *)a, y = *(const uint32_t *)b;
+    return x < y ? -1 : (x > y ? 1 : 0);
+}
+
+/** ==========[ BENCH RUN ]========== **
+ *  Time fn() over `iterations` x `batch` calls
+ *  @param iterations : clamped to BENCH_MAX_SAMPLES
+ *  @param batch      : calls per timed iteration (1 for anything slower than a few us)
+ *  @param prep       : run before each iteration, not timed (e.g. wait for background work)
+ */
+template <typename F, typename P>
+BenchResult benchRun(const char *name, uint32_t iterations, uint32_t batch, F fn, P prep) {
+    if (iterations > BENCH_MAX_SAMPLES) iterations = BENCH_MAX_SAMPLES;
+    if (iterations == 0) iterations = 1;
+    if (batch == 0) batch = 1;
+
+    uint64_t total = 0;
+    for (uint32_t i = 0; i < iterations; i++) {
+        prep();
+        uint32_t start = micros();
+        for (uint32_t b = 0; b < batch; b++) {
+            fn();
+        }
+        benchTicks[i] = micros() - start;
+        total += benchTicks[i];
+    }
+    qsort(benchTicks, iterations, sizeof(benchTicks[0]), benchCompare);
+
+    BenchResult r;
+    r.name = name;
+    r.n = iterations;
+    r.batch = batch;
+    r.mean = (float)total / ((float)iterations * batch);
+    r.opsPerSec = total ? 1e6f * iterations * batch / total : 0.0f;
+    r.p50 = (float)benchTicks[iterations * 50 / 100] / batch;
+    r.p90 = (float)benchTicks[iterations * 90 / 100] / batch;
+    r.p99 = (float)benchTicks[iterations * 99 / 100] / batch;
+    r.max = (float)benchTicks[iterations - 1] / batch;
+    return r;
+}
+
+template <typename F>
+BenchResult benchRun(const char *name, uint32_t iterations, uint32_t batch, F fn) {
+    return benchRun(name, iterations, batch, fn, [] {});
+}
+
+/** One line per benchmark: name, iterations, ops/s and per-call percentiles [us] */
+inline void benchPrint(Print &out, const BenchResult &r) {
+    out.printf("[BENCH] %-16s n=%5lu x%-4lu %12.0f ops/s  mean %9.3f  p50 %9.3f  p90 %9.3f  p99 %9.3f  max %9.3f us\n",
+               r.name, (unsigned long)r.n, (unsigned long)r.batch, r.opsPerSec,
+               r.mean, r.p50, r.p90, r.p99, r.max);
+}
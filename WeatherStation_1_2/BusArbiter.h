@@ -0,0 +1,49 @@
+/**
+ *  @file BusArbiter.h
+ *  @brief Mutex arbitration of the shared I2C bus between loop() and the OLED task
+ *
+ *  Holders keep the bus for one short transaction at a time -- a sensor burst read, or one
+ *  OLED_WIRE_CHUNK of framebuffer -- so a sensor read waits behind at most one chunk
+ *  (~0.8 ms at 400 kHz) instead of a whole 1 KB frame. The FreeRTOS mutex inherits
+ *  priority, so the low-priority OLED task cannot stall loop() beyond its current chunk.
+ *  Before begin() locking is a no-op (setup() runs alone).
+ */
+#pragma once
+#include <Arduino.h>
+
+class BusArbiter {
+public:
+    void begin() { mutex = xSemaphoreCreateMutex(); }
+
+    void lock() {
+        if (!mutex) return;
+        if (xSemaphoreTake(mutex, 0) != pdTRUE) {      // held by the other side: wait and book it
+            uint32_t start = micros();
+            xSemaphoreTake(mutex, portMAX_DELAY);
+            contended++;
+            waitUs += micros() - start;
+        }
+        locks++;                        // counters are only written by the holder
+    }
+
+    void unlock() {
+        if (mutex) xSemaphoreGive(mutex);
+    }
+
+    uint32_t locks = 0;                 // Acquisitions
+    uint32_t contended = 0;             // Acquisitions that had to wait
+    uint32_t waitUs = 0;                // Cumulative wait [us]
+
+private:
+    SemaphoreHandle_t mutex = nullptr;
+};
+
+/** Holds the bus for the enclosing scope */
+class BusLock {
+public:
+    explicit BusLock(BusArbiter &bus) : bus(bus) { bus.lock(); }
+    ~BusLock() { bus.unlock(); }
+
+private:
+    BusArbiter &bus;
+};
@@ -0,0 +1,149 @@
+/**
+ *  @file Derived.h
+ *  @brief Derived metrics -- dew point, absolute humidity, heat index and the 3 h pressure tendency
+ *
+ *  All of them are O(1). The Magnus formulas need one log and one exp per sample; both run
+ *  on a quartic over the float mantissa (fastLog2() / fastExp2(), no logf()/expf()/powf()).
+ *  The heat index is the NWS regression, already a polynomial. The tendency compares the
+ *  mean pressure of two closed statistics windows three hours apart, kept in a small ring,
+ *  so no history is scanned.
+ */
+#pragma once
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+#include "Sample.h"
+
+#define DERIVED_MAGNUS_B 17.62f         // Magnus coefficients over water (-45 .. 60 C)
+#define DERIVED_MAGNUS_C 243.12f        // [C]
+#define DERIVED_MAGNUS_E0 6.112f        // Saturation vapour pressure at 0 C [hPa]
+#define DERIVED_RH_MIN 0.5f             // Humidity floor of the dew point: ln(0) diverges [%]
+#define TREND_STEADY_HPA 1.6f           // |change| over 3 h below this is steady [hPa]
+#define TREND_FAST_HPA 3.6f             // |change| over 3 h from this on is rapid [hPa]
+
+/** ==========[ FAST LOG / EXP ]========== **
+ *  log2 splits off the float exponent and fits log2(1 + f), f in [0, 1), with a quartic
+ *  (|error| < 2.1e-4); exp2 splits off the integer part and fits 2^f (relative error < 7.3e-6).
+ */
+inline float fastLog2(float x) {        // x > 0
+    uint32_t bits;
+    memcpy(&bits, &x, sizeof(bits));
+    float e = (float)((int32_t)(bits >> 23) - 127);
+    bits = (bits & 0x007FFFFF) | 0x3F800000;           // mantissa as 1.f
+    float m;
+    memcpy(&m, &bits, sizeof(m));
+    float f = m - 1.0f;
+    return e + 0.00020372331f + f * (1.4361024f + f * (-0.66952725f + f * (0.31222615f + f * -0.079153834f)));
+}
+
+inline float fastExp2(float x) {
+    if (x < -126.0f) return 0.0f;
+    if (x > 127.0f) x = 127.0f;
+    int32_t i = (int32_t)x;
+    if ((float)i > x) i--;                              // floor for negative x
+    float f = x - i;
+    float p = 1.0000073f + f * (0.69293141f + f * (0.24170999f + f * (0.051667028f + f * 0.013676561f)));
+    uint32_t bits = (uint32_t)(i + 127) << 23;
+    float scale;
+    memcpy(&scale, &bits, sizeof(scale));
+    return p * scale;
+}
+
+inline float fastLn(float x) { return fastLog2(x) * 0.69314718f; }
+inline float fastExp(float x) { return fastExp2(x * 1.44269504f); }
+
+inline float celsiusToF(float c) { return c * 1.8f + 32.0f; }
+
+/** ==========[ COMFORT METRICS ]========== **/
+struct DerivedMetrics {
+    float dewPointC;                    // [C]
+    float absHumidity;                  // water vapour density [g/m^3]
+    float heatIndexC;                   // apparent temperature (NWS), the air temperature when cool [C]
+};
+
+/** NWS heat index from temperature [F] and humidity [%RH]
+ *  Steadman's simple formula below 80 F, the Rothfusz regression with its two corrections above. */
+inline float heatIndexF(float t, float rh) {
+    float hi = 0.5f * (t + 61.0f + (t - 68.0f) * 1.2f + rh * 0.094f);
+    if ((hi + t) * 0.5f < 80.0f) {
+        return hi;
+    }
+    hi = -42.379f + 2.04901523f * t + 10.14333127f * rh - 0.22475541f * t * rh
+         - 0.00683783f * t * t - 0.05481717f * rh * rh + 0.00122874f * t * t * rh
+         + 0.00085282f * t * rh * rh - 0.00000199f * t * t * rh * rh;
+    if (rh < 13.0f && t >= 80.0f && t <= 112.0f) {
+        hi -= (13.0f - rh) * 0.25f * sqrtf((17.0f - fabsf(t - 95.0f)) / 17.0f);
+    } else if (rh > 85.0f && t >= 80.0f && t <= 87.0f) {
+        hi += (rh - 85.0f) * 0.1f * (87.0f - t) * 0.2f;
+    }
+    return hi;
+}
+
+/** Dew point, absolute humidity and heat index of one (valid) sample
+ *  The temperature term b*T/(c+T) is shared: ln of it for the dew point, exp for the
+ *  saturation vapour pressure -- one divide, one fastLn() and one fastExp() in all. */
+inline DerivedMetrics deriveMetrics(const Sample &s) {
+    float t = sampleTempC(s);
+    float rh = sampleHumid(s);
+    float m = DERIVED_MAGNUS_B * t / (DERIVED_MAGNUS_C + t);
+    float gamma = fastLn((rh > DERIVED_RH_MIN ? rh : DERIVED_RH_MIN) * 0.01f) + m;
+    float vapourHPa = DERIVED_MAGNUS_E0 * fastExp(m) * rh * 0.01f;
+
+    DerivedMetrics d;
+    d.dewPointC = DERIVED_MAGNUS_C * gamma / (DERIVED_MAGNUS_B - gamma);
+    d.absHumidity = 216.7f * vapourHPa / (273.15f + t);
+    d.heatIndexC = (heatIndexF(celsiusToF(t), rh) - 32.0f) / 1.8f;
+    return d;
+}
+
+/** ==========[ PRESSURE TREND ]========== **/
+enum PressureTendency : int8_t {
+    TREND_UNKNOWN = 0,                  // less than 3 h of windows so far
+    TREND_FALLING_FAST,
+    TREND_FALLING,
+    TREND_STEADY,
+    TREND_RISING,
+    TREND_RISING_FAST,
+};
+
+inline const char *tendencyName(int8_t t) {
+    static const char *const names[] = { "unknown", "falling fast", "falling", "steady", "rising", "rising fast" };
+    return t >= TREND_UNKNOWN && t <= TREND_RISING_FAST ? names[t] : names[TREND_UNKNOWN];
+}
+
+/** Classify a pressure change over 3 h [hPa] */
+inline PressureTendency classifyTendency(float change) {
+    if (change <= -TREND_FAST_HPA) return TREND_FALLING_FAST;
+    if (change <= -TREND_STEADY_HPA) return TREND_FALLING;
+    if (change < TREND_STEADY_HPA) return TREND_STEADY;
+    if (change < TREND_FAST_HPA) return TREND_RISING;
+    return TREND_RISING_FAST;
+}
+
+/** Mean pressure of the last N + 1 closed windows; the change spans N windows
+ *  (N = 18 for 3 h of 10 min windows). One store per closed window. */
+template <uint8_t N>
+class PressureTrend {
+public:
+    /** @param hPa : mean pressure of the window that just closed */
+    void push(float hPa) {
+        ring[pos] = hPa;
+        pos = pos < N ? pos + 1 : 0;
+        if (fill <= N) fill++;
+    }
+
+    bool ready() const { return fill > N; }
+
+    /** Newest window mean minus the one N windows earlier [hPa] (0 until ready()) */
+    float change() const {
+        if (!ready()) return 0.0f;
+        uint8_t newest = pos ? pos - 1 : N;
+        return ring[newest] - ring[pos];               // pos is the oldest once the ring is full
+    }
+
+    PressureTendency tendency() const { return ready() ? classifyTendency(change()) : TREND_UNKNOWN; }
+
+private:
+    float ring[N + 1];
+    uint8_t pos = 0, fill = 0;
+};
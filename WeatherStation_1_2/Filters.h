@@ -0,0 +1,137 @@
+/**
+ *  @file Filters.h
+ *  @brief Per-channel software smoothing of Samples: running median, fixed-point EMA, decimation
+ *
+ *  Each channel runs a ChannelFilter<MEDIAN, SHIFT>: a running median over the last MEDIAN
+ *  values rejects single-sample spikes, then an EMA with alpha = 1 / 2^SHIFT smooths the
+ *  noise. Both work on the integer Sample channels (0.01 C, 0.01 %RH, Pa), so a sample costs
+ *  a few compares and shifts and no float math. Window sizes and shifts are template
+ *  parameters: MEDIAN 1 / SHIFT 0 compile the stage out.
+ */
+#pragma once
+#include <stdint.h>
+#include "Sample.h"
+
+#define FILTER_EMA_FRAC 8               // Fractional bits of the EMA state
+
+/** ==========[ RUNNING MEDIAN ]========== **
+ *  Median of the last N values (N odd and small: the window is sorted per push)
+ *  Until the window has filled, the median of the values seen so far.
+ */
+template <uint8_t N>
+class RunningMedian {
+public:
+    int32_t push(int32_t x) {
+        win[pos] = x;
+        pos = pos + 1 < N ? pos + 1 : 0;
+        if (fill < N) fill++;
+
+        int32_t s[N];
+        for (uint8_t i = 0; i < fill; i++) {            // insertion sort of a copy
+            int32_t v = win[i];
+            uint8_t j = i;
+            for (; j > 0 && s[j - 1] > v; j--) s[j] = s[j - 1];
+            s[j] = v;
+        }
+        return s[fill / 2];
+    }
+
+    void reset() { fill = pos = 0; }
+
+private:
+    int32_t win[N];
+    uint8_t pos = 0, fill = 0;
+};
+
+template <>
+class RunningMedian<1> {
+public:
+    int32_t push(int32_t x) { return x; }
+    void reset() {}
+};
+
+/** ==========[ EMA ]========== **
+ *  Exponential moving average, alpha = 1 / 2^SHIFT, seeded with the first value
+ *  The state keeps FILTER_EMA_FRAC fractional bits so small steps are not lost to truncation.
+ */
+template <uint8_t SHIFT>
+class Ema {
+public:
+    int32_t push(int32_t x) {
+        int32_t v = x * (1 << FILTER_EMA_FRAC);
+        acc = seeded ? acc + ((v - acc) >> SHIFT) : v;
+        seeded = true;
+        return (acc + (1 << (FILTER_EMA_FRAC - 1))) >> FILTER_EMA_FRAC;
+    }
+
+    void reset() { seeded = false; }
+
+private:
+    int32_t acc = 0;
+    bool seeded = false;
+};
+
+template <>
+class Ema<0> {
+public:
+    int32_t push(int32_t x) { return x; }
+    void reset() {}
+};
+
+/** ==========[ CHANNEL FILTER ]========== **/
+template <uint8_t MEDIAN, uint8_t SHIFT>
+class ChannelFilter {
+public:
+    int32_t push(int32_t x) { return ema.push(median.push(x)); }
+
+    void reset() {
+        median.reset();
+        ema.reset();
+    }
+
+private:
+    RunningMedian<MEDIAN> median;
+    Ema<SHIFT> ema;
+};
+
+/** ==========[ SAMPLE FILTER ]========== **
+ *  Filter all three channels and pass every decimate-th result on
+ *  An invalid sample passes straight through and restarts the filters, so a sensor
+ *  error shows up at once and the next good reading is not blended with stale state.
+ */
+template <typename TempFilter, typename HumidFilter, typename PressFilter>
+class SampleFilter {
+public:
+    explicit SampleFilter(uint8_t decimate = 1) : decimate(decimate ? decimate : 1) {}
+
+    /** @param out : filtered sample, written only when true is returned
+     *  @return false while decimation holds the output back */
+    bool push(const Sample &in, Sample &out) {
+        if (!sampleValid(in)) {
+            temp.reset();
+            humid.reset();
+            press.reset();
+            skipped = 0;
+            out = in;
+            return true;
+        }
+        Sample f;
+        f.time = in.time;
+        f.temp = (int16_t)temp.push(in.temp);
+        f.humid = (uint16_t)humid.push(in.humid);
+        f.pressure = (uint32_t)press.push((int32_t)in.pressure);
+        if (++skipped < decimate) {
+            return false;
+        }
+        skipped = 0;
+        out = f;
+        return true;
+    }
+
+private:
+    TempFilter temp;
+    HumidFilter humid;
+    PressFilter press;
+    uint8_t decimate;
+    uint8_t skipped = 0;
+};
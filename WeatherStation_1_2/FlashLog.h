@@ -0,0 +1,192 @@
+/**
+ *  @file FlashLog.h
+ *  @brief Append-only, segment-rotated log of packed Samples on LittleFS for multi-day outages
+ *
+ *  Records are staged in a RAM page of FLASHLOG_PAGE_RECORDS (252 bytes, one 256-byte flash
+ *  page) and written with one append when it fills, so flash only ever sees whole pages.
+ *  Pages go to numbered segment files of FLASHLOG_SEGMENT_PAGES pages (about one 4 KB
+ *  erase block each). A 16-byte index file keeps the upload cursor: the oldest segment and
+ *  the records of it already acknowledged. It is rewritten only on rotation and
+ *  acknowledgement, never per record.
+ *
+ *  Readers peek() a run of records, upload them and consume() them once acknowledged;
+ *  fully consumed segments are deleted. When the log is full the oldest segment is dropped.
+ *  The staged page is served from RAM when the files are drained, so a short outage never
+ *  writes a partial page -- and is lost on a reset, like the RAM history.
+ */
+#pragma once
+#include <FS.h>
+#include <stdio.h>
+#include <string.h>
+#include "Sample.h"
+
+#define FLASHLOG_DIR "/fblog"
+#define FLASHLOG_INDEX FLASHLOG_DIR "/index"
+#define FLASHLOG_MAGIC 0x474F4C46       // "FLOG"
+#define FLASHLOG_PAGE_RECORDS (256 / sizeof(Sample))
+
+class FlashLog {
+public:
+    /** @param segmentPages : pages per segment file
+     *  @param maxSegments  : segment files kept before the oldest is dropped */
+    FlashLog(uint16_t segmentPages, uint16_t maxSegments)
+        : segmentRecords(segmentPages * FLASHLOG_PAGE_RECORDS), maxSegments(maxSegments) {}
+
+    /** Load the index and count the stored records
+     *  @return false if the file system is unusable */
+    bool begin(fs::FS &fs) {
+        this->fs = &fs;
+        if (!fs.exists(FLASHLOG_DIR) && !fs.mkdir(FLASHLOG_DIR)) {
+            return false;
+        }
+        Index idx;
+        File f = fs.open(FLASHLOG_INDEX, "r");
+        if (f && f.read((uint8_t *)&idx, sizeof(idx)) == sizeof(idx) && idx.magic == FLASHLOG_MAGIC) {
+            firstSeq = idx.firstSeq;
+            firstOffset = idx.firstOffset;
+            headSeq = idx.headSeq;
+        }
+        if (f) f.close();
+
+        stored = 0;
+        for (uint32_t seq = firstSeq; seq != headSeq + 1; seq++) {
+            stored += records(seq);
+        }
+        headRecords = records(headSeq);
+        stored = stored > firstOffset ? stored - firstOffset : 0;
+        return true;
+    }
+
+    /** Stage one record; a full page is written out (retried on the next append if that fails)
+     *  @return false if the record was dropped: the staged page is full and still cannot be written */
+    bool append(const Sample &s) {
+        if (pageCount == FLASHLOG_PAGE_RECORDS && !writePage()) {
+            dropped++;
+            return false;
+        }
+        page[pageCount++] = s;
+        if (pageCount == FLASHLOG_PAGE_RECORDS) {
+            writePage();
+        }
+        return true;
+    }
+
+    /** Copy up to max of the oldest records without removing them
+     *  A run never spans two segments.
+     *  @return records copied */
+    size_t peek(Sample *out, size_t max) {
+        if (stored == 0) {
+            size_t n = max < pageCount ? max : pageCount;
+            memcpy(out, page, n * sizeof(Sample));
+            return n;
+        }
+        uint32_t avail = records(firstSeq) - firstOffset;
+        size_t n = max < avail ? max : avail;
+        File f = open(firstSeq, "r");
+        if (!f || !f.seek(firstOffset * sizeof(Sample))) {
+            return 0;
+        }
+        n = f.read((uint8_t *)out, n * sizeof(Sample)) / sizeof(Sample);
+        f.close();
+        return n;
+    }
+
+    /** Drop the n oldest records after they were acknowledged */
+    void consume(size_t n) {
+        if (stored == 0) {
+            n = n < pageCount ? n : pageCount;
+            memmove(page, page + n, (pageCount - n) * sizeof(Sample));
+            pageCount -= n;
+            return;
+        }
+        firstOffset += n;
+        stored -= n;
+        if (firstOffset >= records(firstSeq)) {
+            fs->remove(path(firstSeq));
+            if (firstSeq == headSeq) {
+                headRecords = 0;        // drained: the head restarts empty
+            } else {
+                firstSeq++;
+            }
+            firstOffset = 0;
+        }
+        saveIndex();
+    }
+
+    /** Records waiting for upload (files and the staged page) */
+    uint32_t size() const { return stored + pageCount; }
+
+    uint32_t dropped = 0;               // records lost to a full log or a write error
+
+private:
+    struct Index {
+        uint32_t magic;
+        uint32_t firstSeq, firstOffset; // upload cursor
+        uint32_t headSeq;               // segment being appended to
+    };
+
+    bool writePage() {
+        if (headRecords + pageCount > segmentRecords) {
+            rotate();
+        }
+        File f = open(headSeq, "a");
+        size_t len = pageCount * sizeof(Sample);
+        bool ok = f && f.write((const uint8_t *)page, len) == len;
+        if (f) f.close();
+        if (!ok) {
+            return false;
+        }
+        headRecords += pageCount;
+        stored += pageCount;
+        pageCount = 0;
+        return true;
+    }
+
+    void rotate() {
+        headSeq++;
+        headRecords = 0;
+        if (headSeq - firstSeq >= maxSegments) {
+            uint32_t lost = records(firstSeq) - firstOffset;
+            fs->remove(path(firstSeq));
+            stored -= lost;
+            dropped += lost;
+            firstSeq++;
+            firstOffset = 0;
+        }
+        saveIndex();
+    }
+
+    void saveIndex() {
+        Index idx = { FLASHLOG_MAGIC, firstSeq, firstOffset, headSeq };
+        File f = fs->open(FLASHLOG_INDEX, "w");
+        if (f) {
+            f.write((const uint8_t *)&idx, sizeof(idx));
+            f.close();
+        }
+    }
+
+    uint32_t records(uint32_t seq) {
+        if (!fs->exists(path(seq))) return 0;
+        File f = open(seq, "r");
+        uint32_t n = f ? f.size() / sizeof(Sample) : 0;
+        if (f) f.close();
+        return n;
+    }
+
+    File open(uint32_t seq, const char *mode) { return fs->open(path(seq), mode); }
+
+    const char *path(uint32_t seq) {
+        snprintf(pathBuf, sizeof(pathBuf), FLASHLOG_DIR "/%08lu", (unsigned long)seq);
+        return pathBuf;
+    }
+
+    fs::FS *fs = nullptr;
+    const uint32_t segmentRecords;
+    const uint16_t maxSegments;
+    uint32_t firstSeq = 0, firstOffset = 0, headSeq = 0;
+    uint32_t headRecords = 0;           // records in the head segment file
+    uint32_t stored = 0;                // unconsumed records in the files
+    Sample page[FLASHLOG_PAGE_RECORDS]; // staged records, oldest first
+    uint8_t pageCount = 0;
+    char pathBuf[24];
+};
@@ -0,0 +1,69 @@
+/**
+ *  @file Health.h
+ *  @brief Health metrics of a running station -- loop and upload latency, failure counts, heap fragmentation
+ *
+ *  The counters are plain accumulators; the sketch snapshots them into FB_ROOT/health and
+ *  starts a new window with reset(), so max and mean always cover one report interval
+ *  while the ok / failed totals run since boot.
+ */
+#pragma once
+#include <stdint.h>
+
+/** Duration of a recurring operation: last, max and mean since the last reset() */
+struct LatencyStats {
+    uint32_t n = 0;
+    uint32_t last = 0, max = 0;
+    uint64_t sum = 0;
+
+    void add(uint32_t v) {
+        n++;
+        last = v;
+        sum += v;
+        if (v > max) max = v;
+    }
+
+    uint32_t mean() const { return n ? (uint32_t)(sum / n) : 0; }
+
+    /** Start a new window (last is kept) */
+    void reset() {
+        n = max = 0;
+        sum = 0;
+    }
+};
+
+/** Outcome and duration of every upload attempt */
+struct UploadHealth {
+    uint32_t ok = 0, failed = 0;        // since boot
+    uint32_t windowFailed = 0;          // in the current window
+    LatencyStats ms;                    // attempt durations in the current window [ms]
+
+    void add(bool success, uint32_t elapsed) {
+        ms.add(elapsed);
+        if (success) {
+            ok++;
+        } else {
+            failed++;
+            windowFailed++;
+        }
+    }
+
+    /** Successful attempts in the current window [%] (100 without attempts) */
+    uint8_t successPct() const {
+        return ms.n ? (uint8_t)((ms.n - windowFailed) * 100 / ms.n) : 100;
+    }
+
+    void reset() {
+        ms.reset();
+        windowFailed = 0;
+    }
+};
+
+/** Share of the free heap not available as one block [%]
+ *  0 is one contiguous region; near 100 the heap is shredded into small chunks, and the next
+ *  large allocation (a TLS session needs ~16 KB contiguous) fails although enough is free. */
+inline uint8_t heapFragmentation(uint32_t freeBytes, uint32_t largest) {
+    if (freeBytes == 0 || largest >= freeBytes) {
+        return 0;
+    }
+    return (uint8_t)(100 - (uint64_t)largest * 100 / freeBytes);
+}
@@ -0,0 +1,30 @@
+/**
+ *  @file I2CStats.h
+ *  @brief Per-device I2C bus accounting -- transactions, payload bytes and bus time
+ *
+ *  A transaction is one logical bus operation: a register burst read, a partial
+ *  OLED window or a full framebuffer push.
+ */
+#pragma once
+#include <stdint.h>
+
+struct I2CStats {
+    uint32_t txns = 0;                  // Transactions
+    uint32_t bytes = 0;                 // Payload bytes moved
+    uint32_t us = 0;                    // Cumulative time on the bus [us]
+
+    void add(uint32_t n, uint32_t elapsed) {
+        txns++;
+        bytes += n;
+        us += elapsed;
+    }
+
+    /** Difference to an earlier snapshot (wrap-safe) */
+    I2CStats since(const I2CStats &prev) const {
+        I2CStats d;
+        d.txns = txns - prev.txns;
+        d.bytes = bytes - prev.bytes;
+        d.us = us - prev.us;
+        return d;
+    }
+};
@@ -0,0 +1,118 @@
+/**
+ *  @file JsonArena.h
+ *  @brief Allocation-free JSON serialization into a caller-owned char arena
+ *
+ *  Values are written as fixed-format decimals straight from the Sample's fixed-point
+ *  channels (the value is an integer, the decimals only place the point), so a record
+ *  needs neither a JSON tree nor printf nor float math. Writing past the end of the arena
+ *  sets a sticky overflow flag instead of truncating silently; check ok() before sending.
+ */
+#pragma once
+#include <stdint.h>
+#include <string.h>
+#include "Sample.h"
+
+class JsonArena {
+public:
+    JsonArena(char *buf, size_t cap) : buf(buf), cap(cap) { clear(); }
+
+    void clear() {
+        len = 0;
+        overflow = false;
+        if (cap) buf[0] = '\0';
+    }
+
+    JsonArena &open() { return put('{'); }
+    JsonArena &close() { return put('}'); }
+
+    /** "key": -- with the separating comma unless it is the first member */
+    JsonArena &key(const char *k) {
+        if (len && buf[len - 1] != '{') put(',');
+        put('"');
+        append(k, strlen(k));
+        return put('"').put(':');
+    }
+
+    JsonArena &u32(uint32_t v) {
+        char d[10];
+        uint8_t n = 0;
+        do {
+            d[n++] = '0' + v % 10;
+            v /= 10;
+        } while (v);
+        while (n) put(d[--n]);
+        return *this;
+    }
+
+    /** Fixed-point value: fixed(2150, 2) writes 21.50, fixed(-5, 2) writes -0.05 */
+    JsonArena &fixed(int32_t v, uint8_t decimals) {
+        uint32_t mag = v < 0 ? 0u - (uint32_t)v : (uint32_t)v;
+        if (v < 0) put('-');
+        uint32_t scale = 1;
+        for (uint8_t i = 0; i < decimals; i++) scale *= 10;
+        u32(mag / scale);
+        if (decimals) {
+            put('.');
+            uint32_t frac = mag % scale;
+            for (scale /= 10; scale; scale /= 10) {
+                put('0' + frac / scale % 10);
+            }
+        }
+        return *this;
+    }
+
+    /** Float rounded to a fixed number of decimals (for derived values such as altitude) */
+    JsonArena &real(float v, uint8_t decimals) {
+        float scale = 1;
+        for (uint8_t i = 0; i < decimals; i++) scale *= 10;
+        float r = v * scale;
+        return fixed((int32_t)(r < 0 ? r - 0.5f : r + 0.5f), decimals);
+    }
+
+    /** Firebase server value: the database fills in its own time [ms] */
+    JsonArena &serverTimestamp() { return raw("{\".sv\":\"timestamp\"}"); }
+
+    JsonArena &raw(const char *s) { return append(s, strlen(s)); }
+
+    bool ok() const { return !overflow; }
+    const char *data() const { return buf; }
+    size_t size() const { return len; }
+
+private:
+    JsonArena &put(char c) { return append(&c, 1); }
+
+    JsonArena &append(const char *s, size_t n) {
+        if (overflow || len + n + 1 > cap) {
+            overflow = true;
+            return *this;
+        }
+        memcpy(buf + len, s, n);
+        len += n;
+        buf[len] = '\0';
+        return *this;
+    }
+
+    char *buf;
+    size_t cap;
+    size_t len;
+    bool overflow;
+};
+
+/** ==========[ LOG RECORD ]========== **
+ *  {"time":1700000000,"humidity":45.07,"temperature":{"C":21.50,"F":70.70},"Pressure":1.00653,
+ *   "ts":{".sv":"timestamp"}} -- same units as the live nodes (%, C/F, Bar)
+ */
+inline void sampleLogJson(JsonArena &j, const Sample &s) {
+    int32_t f = (int32_t)s.temp * 18;                   // [0.001 F] above 32 F
+    f = (f + (f < 0 ? -5 : 5)) / 10 + 3200;             // [0.01 F]
+    j.open();
+    j.key("time").u32(s.time);
+    j.key("humidity").fixed(s.humid, 2);
+    j.key("temperature").open();
+    j.key("C").fixed(s.temp, 2);
+    j.key("F").fixed(f, 2);
+    j.close();
+    j.key("Pressure").fixed((int32_t)s.pressure, 5);
+    j.key("ts").serverTimestamp();
+    j.close();
+}
@@ -0,0 +1,41 @@
+/**
+ *  @file Log.h
+ *  @brief Leveled logging -- one snprintf into a stack buffer and one Serial.write() per line
+ *
+ *  Nothing touches the heap, and a line from the uploader task cannot interleave with
+ *  one from loop(). Calls above LOG_LEVEL (config.h) sit behind a constant-false branch:
+ *  they are still type-checked but compile to nothing, format strings included.
+ */
+#pragma once
+#include <Arduino.h>
+#include <stdarg.h>
+#include "config.h"
+
+#define LOG_LEVEL_NONE 0
+#define LOG_LEVEL_ERROR 1
+#define LOG_LEVEL_INFO 2
+#define LOG_LEVEL_DEBUG 3               // periodic readings and statistics
+
+#define LOG_LINE_MAX 160                // Longer lines are truncated
+
+/** ==========[ LOG LINE ]========== **
+ *  Format "[tag] message\n" (or just the message without a tag) and write it at once
+ */
+__attribute__((format(printf, 2, 3)))
+inline void logLine(const char *tag, const char *fmt, ...) {
+    char buf[LOG_LINE_MAX];
+    int n = tag ? snprintf(buf, sizeof(buf), "[%s] ", tag) : 0;
+    va_list args;
+    va_start(args, fmt);
+    int m = vsnprintf(buf + n, sizeof(buf) - n, fmt, args);
+    va_end(args);
+    size_t len = m < 0 ? n : n + m;
+    if (len > sizeof(buf) - 2) len = sizeof(buf) - 2;
+    buf[len++] = '\n';
+    Serial.write((const uint8_t *)buf, len);
+}
+
+#define LOG(level, tag, ...) do { if ((level) <= LOG_LEVEL) logLine(tag, __VA_ARGS__); } while (0)
+#define LOG_ERROR(...) LOG(LOG_LEVEL_ERROR, "ERROR", __VA_ARGS__)
+#define LOG_INFO(...) LOG(LOG_LEVEL_INFO, "INFO", __VA_ARGS__)
+#define LOG_DEBUG(tag, ...) LOG(LOG_LEVEL_DEBUG, tag, __VA_ARGS__)
@@ -0,0 +1,63 @@
+/**
+ *  @file OfflineBacklog.h
+ *  @brief Readings waiting for upload -- the RAM ring first, the flash log behind it
+ *
+ *  Readings are stored in arrival order across both tiers: the ring takes them until it is
+ *  full, then the flash log takes every reading until it has drained again, so the ring
+ *  always holds the oldest ones and nothing is stored twice or evicted. Draining follows
+ *  the same order: the ring first, then the flash log.
+ *  Without a flash log the ring overwrites its oldest reading when full, as before.
+ *  Not thread safe: use it from the uploader task only.
+ */
+#pragma once
+#include <string.h>
+#include "FlashLog.h"
+#include "RingBuffer.h"
+#include "Sample.h"
+
+template <size_t N>
+class OfflineBacklog {
+public:
+    /** Put a usable flash log behind the ring (nullptr: RAM only) */
+    void attach(FlashLog *log) { flash = log; }
+
+    /** Keep a reading that could not be uploaded
+     *  @return false if a reading was lost (this one, or the oldest one without a flash log) */
+    bool store(const Sample &s) {
+        if (flash && (ram.full() || flash->size())) {
+            return flash->append(s);
+        }
+        return ram.push(s);
+    }
+
+    /** True while the oldest readings are in RAM */
+    bool inRam() const { return !ram.empty(); }
+
+    /** Copy up to max of the oldest readings without removing them
+     *  A run never spans the two tiers.
+     *  @return readings copied */
+    size_t peek(Sample *out, size_t max) {
+        if (!ram.empty()) {
+            size_t n = ram.size() < max ? ram.size() : max;
+            for (size_t i = 0; i < n; i++) out[i] = ram.peek(i);
+            return n;
+        }
+        return flash ? flash->peek(out, max) : 0;
+    }
+
+    /** Drop the n oldest readings (the run returned by peek()) after they were acknowledged */
+    void consume(size_t n) {
+        if (!ram.empty()) {
+            ram.pop(n);
+        } else if (flash) {
+            flash->consume(n);
+        }
+    }
+
+    size_t size() const { return ram.size() + (flash ? flash->size() : 0); }
+    bool empty() const { return size() == 0; }
+
+private:
+    RingBuffer<Sample, N> ram;
+    FlashLog *flash = nullptr;
+};
@@ -0,0 +1,119 @@
+/**
+ *  @file OledDirty.h
+ *  @brief Dirty-region tracking and partial SSD1306 refresh
+ *
+ *  Adafruit_SSD1306::display() always pushes the full framebuffer. OledDirty records
+ *  which columns of which pages were drawn into and sends only those windows using
+ *  the controller's page/column address commands (horizontal addressing mode, as set
+ *  up by Adafruit_SSD1306::begin()).
+ *
+ *  The windows can be sent from any buffer (the front buffer of a double-buffered
+ *  renderer), and a bus lock is taken per address window and per data chunk so other
+ *  devices on the bus never wait for more than one chunk.
+ */
+#pragma once
+#include <Wire.h>
+#include <Adafruit_SSD1306.h>
+
+#define OLED_WIRE_CHUNK 31              // Data bytes per I2C write (plus the 0x40 control byte)
+
+/** Bus lock for a panel that has the bus to itself */
+struct OledNoLock {
+    void lock() {}
+    void unlock() {}
+};
+
+template <int16_t W, int16_t H>
+class OledDirty {
+public:
+    static const uint8_t PAGES = H / 8;
+
+    OledDirty() { clear(); }
+
+    /** Mark a pixel rectangle as changed */
+    void mark(int16_t x, int16_t y, int16_t w, int16_t h) {
+        if (w <= 0 || h <= 0) return;
+        int16_t xa = x < 0 ? 0 : x;
+        int16_t xb = x + w > W ? W - 1 : x + w - 1;
+        int16_t pa = (y < 0 ? 0 : y) / 8;
+        int16_t pb = (y + h > H ? H - 1 : y + h - 1) / 8;
+        for (int16_t p = pa; p <= pb; p++) {
+            if (xa < x0[p]) x0[p] = xa;
+            if (xb > x1[p]) x1[p] = xb;
+        }
+    }
+
+    void clear() {
+        for (uint8_t p = 0; p < PAGES; p++) {
+            x0[p] = W;
+            x1[p] = -1;
+        }
+    }
+
+    bool dirty() const {
+        for (uint8_t p = 0; p < PAGES; p++) {
+            if (x0[p] <= x1[p]) return true;
+        }
+        return false;
+    }
+
+    /** Send the dirty windows of the framebuffer to the panel
+     *  Consecutive pages with the same column span share one address window.
+     *  @return framebuffer bytes sent */
+    size_t flush(Adafruit_SSD1306 &display, TwoWire &wire, uint8_t addr) {
+        OledNoLock bus;
+        return flush(display.getBuffer(), display, wire, addr, bus);
+    }
+
+    /** Send the dirty windows of buf, holding bus (lock() / unlock()) for one
+     *  address window or one OLED_WIRE_CHUNK at a time
+     *  @return framebuffer bytes sent */
+    template <typename Lock>
+    size_t flush(const uint8_t *buf, Adafruit_SSD1306 &display, TwoWire &wire, uint8_t addr, Lock &bus) {
+        size_t sent = 0;
+        uint8_t p = 0;
+        while (p < PAGES) {
+            if (x0[p] > x1[p]) { p++; continue; }
+            uint8_t last = p;
+            while (last + 1 < PAGES && x0[last + 1] == x0[p] && x1[last + 1] == x1[p]) last++;
+
+            bus.lock();
+            display.ssd1306_command(SSD1306_PAGEADDR);
+            display.ssd1306_command(p);
+            display.ssd1306_command(last);
+            display.ssd1306_command(SSD1306_COLUMNADDR);
+            display.ssd1306_command(x0[p]);
+            display.ssd1306_command(x1[p]);
+            bus.unlock();
+
+            uint8_t chunk = 0;
+            for (uint8_t q = p; q <= last; q++) {
+                for (int16_t x = x0[p]; x <= x1[p]; x++) {
+                    if (chunk == 0) {
+                        bus.lock();
+                        wire.beginTransmission(addr);
+                        wire.write((uint8_t)0x40);
+                    }
+                    wire.write(buf[q * W + x]);
+                    sent++;
+                    if (++chunk == OLED_WIRE_CHUNK) {
+                        wire.endTransmission();
+                        bus.unlock();
+                        chunk = 0;
+                    }
+                }
+            }
+            if (chunk) {
+                wire.endTransmission();
+                bus.unlock();
+            }
+            p = last + 1;
+        }
+        clear();
+        return sent;
+    }
+
+private:
+    int16_t x0[PAGES];                  // first dirty column per page (W = clean)
+    int16_t x1[PAGES];                  // last dirty column per page (-1 = clean)
+};
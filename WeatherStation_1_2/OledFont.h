@@ -0,0 +1,84 @@
+/**
+ *  @file OledFont.h
+ *  @brief Blit-based size-2 digit font for page-aligned OLED fields
+ *
+ *  GFX draws size-2 text pixel by pixel through drawChar()/fillRect(). The numeric
+ *  fields only ever show digits, '.', '-', ' ' and the C/F unit, so those glyphs are
+ *  kept here (5x7 columns, same bitmaps as the GFX classic font). Each column byte is
+ *  doubled vertically into two framebuffer pages and written twice, i.e. 24 byte stores
+ *  per character instead of ~70 rectangle fills.
+ */
+#pragma once
+#include <stdint.h>
+#include <string.h>
+
+#define OLED_GLYPH_W 5                  // Font columns per glyph (plus one blank column)
+
+static const uint8_t oledDigits[][OLED_GLYPH_W] = {
+    { 0x3E, 0x51, 0x49, 0x45, 0x3E },   // 0
+    { 0x00, 0x42, 0x7F, 0x40, 0x00 },   // 1
+    { 0x72, 0x49, 0x49, 0x49, 0x46 },   // 2
+    { 0x21, 0x41, 0x49, 0x4D, 0x33 },   // 3
+    { 0x18, 0x14, 0x12, 0x7F, 0x10 },   // 4
+    { 0x27, 0x45, 0x45, 0x45, 0x39 },   // 5
+    { 0x3C, 0x4A, 0x49, 0x49, 0x31 },   // 6
+    { 0x41, 0x21, 0x11, 0x09, 0x07 },   // 7
+    { 0x36, 0x49, 0x49, 0x49, 0x36 },   // 8
+    { 0x46, 0x49, 0x49, 0x29, 0x1E },   // 9
+};
+static const uint8_t oledGlyphDot[OLED_GLYPH_W]   = { 0x00, 0x60, 0x60, 0x00, 0x00 };
+static const uint8_t oledGlyphMinus[OLED_GLYPH_W] = { 0x08, 0x08, 0x08, 0x08, 0x08 };
+static const uint8_t oledGlyphSpace[OLED_GLYPH_W] = { 0x00, 0x00, 0x00, 0x00, 0x00 };
+static const uint8_t oledGlyphC[OLED_GLYPH_W]     = { 0x3E, 0x41, 0x41, 0x41, 0x22 };
+static const uint8_t oledGlyphF[OLED_GLYPH_W]     = { 0x7F, 0x09, 0x09, 0x09, 0x01 };
+
+// Nibble with every bit doubled: bit n -> bits 2n, 2n+1
+static const uint8_t oledDouble[16] = {
+    0x00, 0x03, 0x0C, 0x0F, 0x30, 0x33, 0x3C, 0x3F,
+    0xC0, 0xC3, 0xCC, 0xCF, 0xF0, 0xF3, 0xFC, 0xFF
+};
+
+/** Glyph for c, or nullptr if the blit font does not have it */
+inline const uint8_t *oledGlyph(char c) {
+    if (c >= '0' && c <= '9') return oledDigits[c - '0'];
+    switch (c) {
+    case '.': return oledGlyphDot;
+    case '-': return oledGlyphMinus;
+    case ' ': return oledGlyphSpace;
+    case 'C': return oledGlyphC;
+    case 'F': return oledGlyphF;
+    default:  return nullptr;
+    }
+}
+
+/** ==========[ BLIT 2X ]========== **
+ *  Draw text at size 2 into the framebuffer, clearing the whole chars-wide field first
+ *  @param buf   : SSD1306 framebuffer (page-major, width bytes per page)
+ *  @param page  : top page of the field (the field is two pages tall)
+ *  @param chars : field width in characters; longer text is clipped
+ *  @return false (and nothing drawn) if text has a glyph the font lacks
+ */
+inline bool oledBlit2x(uint8_t *buf, int16_t width, int16_t x, uint8_t page, const char *text, uint8_t chars) {
+    for (const char *c = text; *c; c++) {
+        if (!oledGlyph(*c)) return false;
+    }
+    int16_t fieldW = chars * (OLED_GLYPH_W + 1) * 2;
+    if (x + fieldW > width) fieldW = width - x;
+    uint8_t *top = buf + page * width + x;
+    uint8_t *bottom = top + width;
+    memset(top, 0, fieldW);
+    memset(bottom, 0, fieldW);
+
+    int16_t col = 0;
+    for (const char *c = text; *c && col + (OLED_GLYPH_W + 1) * 2 <= fieldW; c++) {
+        const uint8_t *g = oledGlyph(*c);
+        for (uint8_t i = 0; i < OLED_GLYPH_W; i++) {
+            uint8_t lo = oledDouble[g[i] & 0x0F], hi = oledDouble[g[i] >> 4];
+            top[col] = top[col + 1] = lo;
+            bottom[col] = bottom[col + 1] = hi;
+            col += 2;
+        }
+        col += 2;                       // blank column between glyphs
+    }
+    return true;
+}
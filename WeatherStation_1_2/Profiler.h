@@ -0,0 +1,97 @@
+/**
+ *  @file Profiler.h
+ *  @brief Loop-stage profiler -- fixed-bucket latency histograms over esp_timer_get_time()
+ *
+ *  Enable with PROFILE_ENABLE in config.h. When disabled, PROFILE_SCOPE() and
+ *  PROFILE_MARK() expand to nothing and no profiler state is compiled in.
+ */
+#pragma once
+#include <Arduino.h>
+#include "config.h"
+
+#if PROFILE_ENABLE
+#include <esp_timer.h>
+
+enum ProfileStage {
+    PROF_LOOP,                          // one loop() iteration
+    PROF_SAMPLE,                        // readBME()
+    PROF_PERIOD,                        // time between two samples (jitter on bmeDelay)
+    PROF_DISPLAY,                       // printBME()
+    PROF_SERIAL,                        // SerialSink reading line
+    PROF_QUEUE,                         // queueFB()
+    PROF_UPLOAD,                        // updateFB() on the uploader task
+    PROF_COUNT
+};
+
+static const char *const PROF_NAMES[PROF_COUNT] = {
+    "loop", "sample", "period", "display", "serial", "queue", "upload"
+};
+
+// Upper bucket edges [us]; the last bucket catches everything above
+static const uint32_t PROF_EDGES[] = {
+    50, 100, 250, 500, 1000, 2500, 5000, 10000, 25000, 40000, 42000, 50000, 100000, 1000000
+};
+#define PROF_BUCKETS (sizeof(PROF_EDGES) / sizeof(PROF_EDGES[0]) + 1)
+
+struct ProfileHist {
+    uint32_t bucket[PROF_BUCKETS];
+    uint32_t n, max;
+    uint64_t sum;
+
+    void add(uint32_t us) {
+        uint8_t b = 0;
+        while (b < PROF_BUCKETS - 1 && us >= PROF_EDGES[b]) b++;
+        bucket[b]++;
+        n++;
+        sum += us;
+        if (us > max) max = us;
+    }
+};
+
+static ProfileHist profHist[PROF_COUNT];
+
+/** Times the enclosing scope into one stage histogram */
+class ProfileScope {
+public:
+    explicit ProfileScope(ProfileStage stage) : stage(stage), start(esp_timer_get_time()) {}
+    ~ProfileScope() { profHist[stage].add((uint32_t)(esp_timer_get_time() - start)); }
+private:
+    ProfileStage stage;
+    int64_t start;
+};
+
+/** Records the interval since the previous mark of the same stage */
+inline void profileMark(ProfileStage stage) {
+    static int64_t last[PROF_COUNT] = {};
+    int64_t now = esp_timer_get_time();
+    if (last[stage]) profHist[stage].add((uint32_t)(now - last[stage]));
+    last[stage] = now;
+}
+
+/** ==========[ PROFILE DUMP ]========== **
+ *  Print every stage's histogram, mean and max, then start a new window
+ */
+inline void profileDump(Print &out) {
+    out.print("[PROF] stage      n     mean      max |");
+    for (uint8_t b = 0; b < PROF_BUCKETS - 1; b++) out.printf(" <%lu", (unsigned long)PROF_EDGES[b]);
+    out.println(" more");
+    for (uint8_t s = 0; s < PROF_COUNT; s++) {
+        ProfileHist &h = profHist[s];
+        if (h.n == 0) continue;
+        out.printf("[PROF] %-7s %6lu %8lu %8lu |", PROF_NAMES[s], (unsigned long)h.n,
+                   (unsigned long)(h.sum / h.n), (unsigned long)h.max);
+        for (uint8_t b = 0; b < PROF_BUCKETS; b++) out.printf(" %lu", (unsigned long)h.bucket[b]);
+        out.println();
+        h = ProfileHist();
+    }
+}
+
+#define PROFILE_CONCAT_(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_(a, b)
+#define PROFILE_SCOPE(stage) ProfileScope PROFILE_CONCAT(_prof_, __LINE__)(stage)
+#define PROFILE_MARK(stage) profileMark(stage)
+
+#else
+#define PROFILE_SCOPE(stage)
+#define PROFILE_MARK(stage)
+#endif
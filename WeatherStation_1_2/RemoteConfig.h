@@ -0,0 +1,69 @@
+/**
+ *  @file RemoteConfig.h
+ *  @brief Runtime overrides of the station profile, pushed through the FB_ROOT/config stream
+ *
+ *  The node mirrors the StationProfile field names:
+ *      { "sampleMs": 41, "displayMs": 2000, "uploadMs": 600000, "unit": "auto" | "C" | "F" }
+ *  The uploader task parses stream events into a RemoteConfig; loop() takes it over and
+ *  applies only the fields that were set. Out-of-range values are rejected, not clamped,
+ *  so a typo in the console cannot stall sampling or flood the database.
+ */
+#pragma once
+#include <stdint.h>
+#include <string.h>
+
+#define RC_UNSET -1                     // field not present in the update
+#define RC_SAMPLE_MIN 20                // Shortest sample interval (high-rate oversampling) [ms]
+#define RC_DISPLAY_MIN 100              // Shortest OLED refresh [ms]
+#define RC_UPLOAD_MIN 1000              // Shortest upload interval [ms]
+#define RC_PERIOD_MAX 86400000          // Longest interval of any of them (one day) [ms]
+
+enum UnitMode : int8_t {
+    UNIT_ALTERNATE = 0,                 // toggle C / F on every refresh (the original behaviour)
+    UNIT_C,
+    UNIT_F,
+};
+
+struct RemoteConfig {
+    int32_t sampleMs = RC_UNSET;
+    int32_t displayMs = RC_UNSET;
+    int32_t uploadMs = RC_UNSET;
+    int8_t unit = RC_UNSET;             // UnitMode
+
+    /** Set one numeric key
+     *  @return false for an unknown key or an out-of-range value (field left unchanged) */
+    bool set(const char *key, int32_t value) {
+        if (!strcmp(key, "sampleMs")) return assign(sampleMs, value, RC_SAMPLE_MIN);
+        if (!strcmp(key, "displayMs")) return assign(displayMs, value, RC_DISPLAY_MIN);
+        if (!strcmp(key, "uploadMs")) return assign(uploadMs, value, RC_UPLOAD_MIN);
+        return false;
+    }
+
+    /** Set the "unit" key from its string value ("auto", "C" or "F") */
+    bool setUnit(const char *value) {
+        if (!strcmp(value, "auto")) unit = UNIT_ALTERNATE;
+        else if (!strcmp(value, "C")) unit = UNIT_C;
+        else if (!strcmp(value, "F")) unit = UNIT_F;
+        else return false;
+        return true;
+    }
+
+    /** Take over every field set in a newer update */
+    void merge(const RemoteConfig &o) {
+        if (o.sampleMs != RC_UNSET) sampleMs = o.sampleMs;
+        if (o.displayMs != RC_UNSET) displayMs = o.displayMs;
+        if (o.uploadMs != RC_UNSET) uploadMs = o.uploadMs;
+        if (o.unit != RC_UNSET) unit = o.unit;
+    }
+
+    bool empty() const {
+        return sampleMs == RC_UNSET && displayMs == RC_UNSET && uploadMs == RC_UNSET && unit == RC_UNSET;
+    }
+
+private:
+    static bool assign(int32_t &field, int32_t value, int32_t lo) {
+        if (value < lo || value > RC_PERIOD_MAX) return false;
+        field = value;
+        return true;
+    }
+};
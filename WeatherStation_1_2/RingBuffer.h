@@ -0,0 +1,52 @@
+/**
+ *  @file RingBuffer.h
+ *  @brief Fixed-capacity ring buffer -- all storage is preallocated, nothing touches the heap
+ *
+ *  When full, push() overwrites the oldest element so the newest data always survives.
+ *  Not thread safe: use it from a single task.
+ */
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+template <typename T, size_t N>
+class RingBuffer {
+public:
+    /** Append an element, dropping the oldest one when full
+     *  @return false if an element was overwritten */
+    bool push(const T &item) {
+        bool kept = !full();
+        buf[(head + len) % N] = item;
+        if (kept) {
+            len++;
+        } else {
+            head = (head + 1) % N;
+            overwritten++;
+        }
+        return kept;
+    }
+
+    /** Element i positions after the oldest one (0 = oldest) */
+    const T &peek(size_t i) const { return buf[(head + i) % N]; }
+
+    /** Discard the n oldest elements */
+    void pop(size_t n) {
+        if (n > len) n = len;
+        head = (head + n) % N;
+        len -= n;
+    }
+
+    void clear() { head = 0; len = 0; }
+
+    size_t size() const { return len; }
+    bool empty() const { return len == 0; }
+    bool full() const { return len == N; }
+    static size_t capacity() { return N; }
+
+    uint32_t overwritten = 0;   // Elements lost because the buffer was full
+
+private:
+    T buf[N];
+    size_t head = 0;
+    size_t len = 0;
+};
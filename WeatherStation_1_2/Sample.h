@@ -0,0 +1,72 @@
+/**
+ *  @file Sample.h
+ *  @brief Packed BME280 sample -- raw fixed-point channels plus a timestamp (12 bytes)
+ *
+ *  Only measured quantities are stored. Derived units (Fahrenheit, Bar, altitude)
+ *  are computed on demand when a sample is displayed or uploaded.
+ */
+#pragma once
+#include <stdint.h>
+#include <math.h>
+
+#define SAMPLE_INVALID_HUMID 0xFFFF     // Marks a failed sensor read
+
+struct __attribute__((packed)) Sample {
+    uint32_t time;      // [s] epoch
+    uint32_t pressure;  // [Pa]
+    int16_t temp;       // [0.01 C]
+    uint16_t humid;     // [0.01 %RH]
+};
+
+/** ==========[ MAKE SAMPLE ]========== **
+ *  Pack float readings into a Sample, rounding to the stored resolution
+ *  A NaN temperature or humidity yields an invalid sample (see sampleValid()).
+ */
+inline Sample makeSample(uint32_t time, float tempC, float humid, float pressurePa) {
+    Sample s;
+    s.time = time;
+    if (isnan(tempC) || isnan(humid) || isnan(pressurePa)) {
+        s.pressure = 0;
+        s.temp = 0;
+        s.humid = SAMPLE_INVALID_HUMID;
+        return s;
+    }
+    s.pressure = pressurePa > 0 ? (uint32_t)(pressurePa + 0.5f) : 0;
+    s.temp = (int16_t)lroundf(tempC * 100.0f);
+    s.humid = (uint16_t)lroundf(fminf(fmaxf(humid, 0.0f), 100.0f) * 100.0f);
+    return s;
+}
+
+inline bool sampleValid(const Sample &s) { return s.humid != SAMPLE_INVALID_HUMID; }
+
+/** ==========[ DERIVED UNITS ]========== **/
+inline float sampleTempC(const Sample &s) { return s.temp * 0.01f; }                // [C]
+inline float sampleTempF(const Sample &s) { return s.temp * 0.018f + 32.0f; }       // [F]
+inline float sampleHumid(const Sample &s) { return s.humid * 0.01f; }               // [%]
+inline float sampleHPa(const Sample &s) { return s.pressure * 0.01f; }              // [hPa]
+inline float sampleBar(const Sample &s) { return s.pressure * 1e-5f; }              // [Bar]
+
+/** 44330 * (1 - r^0.1903) for r = p / p0 = 0.5, 0.5125 .. 1.1 [m] */
+#define SAMPLE_ALT_LUT_MIN 0.5f
+#define SAMPLE_ALT_LUT_STEP 0.0125f
+#define SAMPLE_ALT_LUT_SIZE 49
+static const float sampleAltLut[SAMPLE_ALT_LUT_SIZE] = {
+    5478.1f, 5295.2f, 5115.7f, 4939.7f, 4767.0f, 4597.5f, 4431.0f,
+    4267.3f, 4106.5f, 3948.4f, 3792.8f, 3639.8f, 3489.1f, 3340.8f,
+    3194.7f, 3050.9f, 2909.1f, 2769.3f, 2631.5f, 2495.7f, 2361.7f,
+    2229.4f, 2099.0f, 1970.2f, 1843.0f, 1717.5f, 1593.5f, 1471.0f,
+    1350.0f, 1230.5f, 1112.3f, 995.5f, 880.0f, 765.8f, 652.8f,
+    541.1f, 430.6f, 321.3f, 213.1f, 106.0f, 0.0f, -104.9f,
+    -208.8f, -311.7f, -413.5f, -514.4f, -614.3f, -713.3f, -811.4f,
+};
+
+/** Barometric altitude for the given sea-level pressure [m]
+ *  Linear interpolation in sampleAltLut instead of powf(): within 0.5 m from
+ *  -800 m to 5500 m, extrapolated from the end segments outside of that. */
+inline float sampleAltitude(const Sample &s, float seaLevelHPa) {
+    float x = (sampleHPa(s) / seaLevelHPa - SAMPLE_ALT_LUT_MIN) / SAMPLE_ALT_LUT_STEP;
+    int i = (int)x;
+    if (x < 0.0f) i = 0;
+    if (i > SAMPLE_ALT_LUT_SIZE - 2) i = SAMPLE_ALT_LUT_SIZE - 2;
+    return sampleAltLut[i] + (sampleAltLut[i + 1] - sampleAltLut[i]) * (x - i);
+}
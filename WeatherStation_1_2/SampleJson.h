@@ -0,0 +1,23 @@
+/**
+ *  @file SampleJson.h
+ *  @brief Compact JSON rendering of Samples for the local HTTP endpoint
+ *
+ *  Written with snprintf into caller buffers straight from the fixed-point channels:
+ *  no heap, no JSON library and no float formatting. Units are C, %RH and Pa.
+ */
+#pragma once
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "Sample.h"
+
+/** ==========[ SAMPLE JSON ]========== **
+ *  {"time":1700000000,"temperature":21.50,"humidity":45.00,"pressure":100653}
+ *  @return characters written (as snprintf; >= len means truncated)
+ */
+inline int sampleJson(char *buf, size_t len, const Sample &s) {
+    int t = s.temp;
+    return snprintf(buf, len, "{\"time\":%lu,\"temperature\":%s%d.%02d,\"humidity\":%u.%02u,\"pressure\":%lu}",
+                    (unsigned long)s.time, t < 0 ? "-" : "", abs(t) / 100, abs(t) % 100,
+                    (unsigned)(s.humid / 100), (unsigned)(s.humid % 100), (unsigned long)s.pressure);
+}
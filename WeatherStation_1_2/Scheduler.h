@@ -0,0 +1,94 @@
+/**
+ *  @file Scheduler.h
+ *  @brief Cooperative deadline scheduler for the periodic jobs of loop()
+ *
+ *  Jobs run in table order when due. Deadlines advance by exactly one period, so
+ *  a job that was delayed does not drift; if it fell a whole period behind it is
+ *  resynchronised and counted as late. Between deadlines the caller blocks in
+ *  idle() instead of polling millis().
+ */
+#pragma once
+#include <Arduino.h>
+#include <esp_timer.h>
+#include <esp_sleep.h>
+
+template <uint8_t N>
+class Scheduler {
+public:
+    typedef void (*JobFn)();
+
+    struct Job {
+        const char *name;
+        JobFn fn;
+        int64_t period;                 // [us]
+        int64_t next;                   // next deadline [us]
+        uint32_t runs, late;
+    };
+
+    /** Register a job; it first runs on the next runDue()
+     *  @return job id, or -1 if the table is full */
+    int8_t add(const char *name, JobFn fn, uint32_t periodMs) {
+        if (count >= N) return -1;
+        Job &j = jobs[count];
+        j.name = name;
+        j.fn = fn;
+        j.period = (int64_t)periodMs * 1000;
+        j.next = esp_timer_get_time();
+        j.runs = j.late = 0;
+        return count++;
+    }
+
+    /** Change a job's period; the next deadline is moved relative to its last run */
+    void setPeriod(int8_t id, uint32_t periodMs) {
+        if (id < 0 || id >= count) return;
+        Job &j = jobs[id];
+        int64_t period = (int64_t)periodMs * 1000;
+        j.next += period - j.period;
+        j.period = period;
+    }
+
+    /** Run every job whose deadline has passed
+     *  @return time until the earliest next deadline [us] */
+    int64_t runDue() {
+        int64_t now = esp_timer_get_time();
+        for (uint8_t i = 0; i < count; i++) {
+            Job &j = jobs[i];
+            if (now < j.next) continue;
+            j.fn();
+            j.runs++;
+            j.next += j.period;
+            now = esp_timer_get_time();
+            if (now >= j.next) {
+                j.next = now + j.period;
+                j.late++;
+            }
+        }
+        int64_t wait = INT64_MAX;
+        for (uint8_t i = 0; i < count; i++) {
+            int64_t d = jobs[i].next - now;
+            if (d < wait) wait = d;
+        }
+        return wait < 0 ? 0 : wait;
+    }
+
+    /** Block until the next deadline
+     *  With lightSleep the whole chip sleeps (only safe when no other task needs the CPU,
+     *  e.g. without WiFi); otherwise the task yields and the idle task runs. */
+    void idle(int64_t wait, bool lightSleep) {
+        if (wait < 1000) return;        // below one tick: just come back around
+        if (lightSleep) {
+            Serial.flush();
+            esp_sleep_enable_timer_wakeup((uint64_t)wait);
+            esp_light_sleep_start();
+        } else {
+            vTaskDelay(pdMS_TO_TICKS(wait / 1000));
+        }
+    }
+
+    const Job &job(int8_t id) const { return jobs[id]; }
+    uint8_t size() const { return count; }
+
+private:
+    Job jobs[N];
+    uint8_t count = 0;
+};
@@ -0,0 +1,143 @@
+/**
+ *  @file SensorRegistry.h
+ *  @brief Additional BME280s on the shared bus, optionally behind a TCA9548A I2C mux
+ *
+ *  All registered sensors run in forced mode and are polled as one pipeline: poll()
+ *  burst-reads the conversions started by the previous poll() and immediately starts
+ *  the next ones, back to back, so every sensor converts in parallel between polls.
+ *  Each sensor is set up from scratch (reset + configure), without Adafruit_BME280.
+ */
+#pragma once
+#include <Arduino.h>
+#include <Wire.h>
+#include "BME280Burst.h"
+#include "I2CStats.h"
+#include "Sample.h"
+
+#define SENSOR_NO_MUX 0xFF              // Sensor sits on the main bus
+
+// Forced-mode setup for the extra sensors: 1x humidity, 2x temperature, 16x pressure;
+// the IIR filter is passed to begin() (the sketch uses BME_HW_FILTER, like the primary sensor)
+#define SENSOR_CTRL_HUM 0x01
+#define SENSOR_CTRL_MEAS 0x54
+
+struct SensorEntry {
+    const char *name;                   // device ID, used as the upload key
+    uint8_t addr;
+    uint8_t mux;                        // mux channel 0-7 or SENSOR_NO_MUX
+    bool present;
+    uint32_t errors;                    // failed reads
+    Sample last;                        // most recent reading (invalid until the first one)
+    BME280Burst dev;
+};
+
+template <uint8_t N>
+class SensorRegistry {
+public:
+    /** Register a sensor; call before begin()
+     *  @return index, or -1 if the registry is full */
+    int8_t add(const char *name, uint8_t addr, uint8_t mux = SENSOR_NO_MUX) {
+        if (count >= N) return -1;
+        SensorEntry &e = sensors[count];
+        e.name = name;
+        e.addr = addr;
+        e.mux = mux;
+        e.present = false;
+        e.errors = 0;
+        e.last = makeSample(0, NAN, NAN, NAN);
+        return count++;
+    }
+
+    /** Reset, probe and configure every registered sensor
+     *  @param muxAddr : address of the TCA9548A, if any sensor uses one
+     *  @param filter  : IIR coefficient 0 (off), 2, 4, 8 or 16 (lags by about N polls)
+     *  @return number of sensors that answered */
+    uint8_t begin(TwoWire &wire, I2CStats *stats = nullptr, uint8_t muxAddr = 0x70, uint8_t filter = 0) {
+        this->wire = &wire;
+        this->stats = stats;
+        this->muxAddr = muxAddr;
+        for (uint8_t i = 0; i < count; i++) {
+            SensorEntry &e = sensors[i];
+            select(e.mux);
+            e.dev.reset(e.addr, wire, stats);
+        }
+        delay(3);                       // trimming NVM copy after reset
+        uint8_t found = 0;
+        for (uint8_t i = 0; i < count; i++) {
+            SensorEntry &e = sensors[i];
+            select(e.mux);
+            e.present = e.dev.begin(e.addr, wire, stats) &&
+                        e.dev.configure(SENSOR_CTRL_HUM, bme280FilterConfig(filter), SENSOR_CTRL_MEAS);
+            found += e.present;
+        }
+        select(SENSOR_NO_MUX);
+        return found;
+    }
+
+    /** One pipeline step: read the finished conversions, then trigger the next round
+     *  @param epoch : timestamp for the new readings [s]
+     *  @return true if new readings were stored; false on the first call or while any
+     *          sensor is still converting (nothing is read or triggered then) */
+    bool poll(uint32_t epoch) {
+        if (triggered) {
+            for (uint8_t i = 0; i < count; i++) {
+                SensorEntry &e = sensors[i];
+                if (!e.present) continue;
+                select(e.mux);
+                if (e.dev.measuring()) {
+                    select(SENSOR_NO_MUX);
+                    return false;
+                }
+            }
+            for (uint8_t i = 0; i < count; i++) {
+                SensorEntry &e = sensors[i];
+                if (!e.present) continue;
+                select(e.mux);
+                int16_t temp;
+                uint16_t humid;
+                uint32_t pressure;
+                if (e.dev.readInt(temp, humid, pressure)) {
+                    e.last.time = epoch;
+                    e.last.temp = temp;
+                    e.last.humid = humid;
+                    e.last.pressure = pressure;
+                } else {
+                    e.last = makeSample(epoch, NAN, NAN, NAN);
+                    e.errors++;
+                }
+            }
+        }
+        for (uint8_t i = 0; i < count; i++) {
+            SensorEntry &e = sensors[i];
+            if (!e.present) continue;
+            select(e.mux);
+            e.dev.trigger();
+        }
+        select(SENSOR_NO_MUX);          // keep the mux closed so its sensors never shadow the main bus
+        bool fresh = triggered;
+        triggered = true;
+        return fresh;
+    }
+
+    const SensorEntry &entry(uint8_t i) const { return sensors[i]; }
+    uint8_t size() const { return count; }
+
+private:
+    void select(uint8_t mux) {
+        if (mux == channel) return;
+        uint32_t start = micros();
+        wire->beginTransmission(muxAddr);
+        wire->write((uint8_t)(mux == SENSOR_NO_MUX ? 0 : 1 << mux));
+        wire->endTransmission();
+        if (stats) stats->add(1, micros() - start);
+        channel = mux;
+    }
+
+    SensorEntry sensors[N];
+    uint8_t count = 0;
+    bool triggered = false;
+    TwoWire *wire = nullptr;
+    I2CStats *stats = nullptr;
+    uint8_t muxAddr = 0x70;
+    uint8_t channel = SENSOR_NO_MUX;    // mux channel currently open
+};
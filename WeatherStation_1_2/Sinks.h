@@ -0,0 +1,63 @@
+/**
+ *  @file Sinks.h
+ *  @brief Static fan-out of new samples to independently rated output sinks
+ *
+ *  A sink is any class with
+ *      bool due(const Sample &s, uint32_t now);    // rate / deadband decision
+ *      void publish(const Sample &s, uint32_t now);
+ *  SinkFanOut<A, B, ...> calls them in order through plain member calls (no virtuals,
+ *  everything inlines). Each sink owns its rate and any queueing, and publish() must not
+ *  block: a slow destination hands off to its own queue or task so the others are never
+ *  held up by it.
+ */
+#pragma once
+#include <stdint.h>
+#include "Sample.h"
+
+/** ==========[ SINK RATE ]========== **
+ *  Fixed-interval rate limit for sinks; period 0 passes every sample
+ *  Like the scheduler, the slot advances by exactly one period so the rate does not
+ *  drift with the sampling grid; a sink that fell a whole period behind resyncs.
+ */
+struct SinkRate {
+    uint32_t period;                    // [ms]
+    uint32_t last = 0;                  // start of the current slot [ms]
+    bool started = false;
+
+    explicit SinkRate(uint32_t periodMs) : period(periodMs) {}
+
+    bool due(uint32_t now) const { return !started || now - last >= period; }
+
+    void accept(uint32_t now) {
+        last = started && now - last < 2 * period ? last + period : now;
+        started = true;
+    }
+};
+
+/** ==========[ FAN OUT ]========== **/
+template <typename... Sinks>
+class SinkFanOut;
+
+template <>
+class SinkFanOut<> {
+public:
+    void offer(const Sample &, uint32_t) {}
+};
+
+template <typename Head, typename... Tail>
+class SinkFanOut<Head, Tail...> : private SinkFanOut<Tail...> {
+public:
+    explicit SinkFanOut(Head &head, Tail &...tail) : SinkFanOut<Tail...>(tail...), head(head) {}
+
+    /** Hand a new sample to every sink that is due
+     *  @param now : [ms] */
+    void offer(const Sample &s, uint32_t now) {
+        if (head.due(s, now)) {
+            head.publish(s, now);
+        }
+        SinkFanOut<Tail...>::offer(s, now);
+    }
+
+private:
+    Head &head;
+};
@@ -0,0 +1,39 @@
+/**
+ *  @file TlsStats.h
+ *  @brief Connection reuse accounting for Firebase RTDB requests
+ *
+ *  FirebaseData keeps its TLS session open between requests. A request that starts
+ *  without a live connection has to do a full TLS handshake first, so its duration
+ *  is booked as handshake time; everything else ran on a reused session.
+ */
+#pragma once
+#include <Firebase_ESP_Client.h>
+
+struct TlsStats {
+    uint32_t requests = 0;              // RTDB requests issued
+    uint32_t handshakes = 0;            // requests that had to open a new session
+    uint32_t handshakeMs = 0;           // cumulative duration of those requests [ms]
+    uint32_t reusedMs = 0;              // cumulative duration of requests on a reused session [ms]
+    uint32_t lastHandshakeMs = 0;       // duration of the most recent handshake request [ms]
+    uint32_t lastRequest = 0;           // millis() at the end of the last request
+
+    /** Run one request and book it
+     *  @param request : callable returning the RTDB call's result */
+    template <typename F>
+    bool run(FirebaseData &fbdo, F request) {
+        bool fresh = !fbdo.httpConnected();
+        uint32_t start = millis();
+        bool ok = request();
+        lastRequest = millis();
+        uint32_t ms = lastRequest - start;
+        requests++;
+        if (fresh) {
+            handshakes++;
+            handshakeMs += ms;
+            lastHandshakeMs = ms;
+        } else {
+            reusedMs += ms;
+        }
+        return ok;
+    }
+};
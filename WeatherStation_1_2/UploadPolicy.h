@@ -0,0 +1,62 @@
+/**
+ *  @file UploadPolicy.h
+ *  @brief Report-by-exception upload policy
+ *
+ *  A sample is due for upload when any channel has moved past its deadband since the
+ *  last uploaded sample, but never sooner than minMs after it (rate limit) and never
+ *  later than maxMs (heartbeat, so a quiet station still shows up as alive).
+ */
+#pragma once
+#include <stdint.h>
+#include "Sample.h"
+
+struct Deadband {
+    uint16_t temp;                      // [0.01 C]
+    uint16_t humid;                     // [0.01 %RH]
+    uint32_t pressure;                  // [Pa]
+};
+
+class UploadPolicy {
+public:
+    enum Reason { NONE, FIRST, DELTA, HEARTBEAT };
+
+    UploadPolicy(const Deadband &band, uint32_t minMs, uint32_t maxMs)
+        : band(band), minMs(minMs), maxMs(maxMs) {}
+
+    /** Decide whether s should be uploaded now
+     *  @param now : [ms] */
+    Reason due(const Sample &s, uint32_t now) const {
+        if (!sent) return FIRST;
+        uint32_t elapsed = now - lastMs;
+        if (elapsed < minMs) return NONE;
+        if (elapsed >= maxMs) return HEARTBEAT;
+        if (absDiff(s.temp, last.temp) >= band.temp ||
+            absDiff(s.humid, last.humid) >= band.humid ||
+            absDiff(s.pressure, last.pressure) >= band.pressure) {
+            return DELTA;
+        }
+        return NONE;
+    }
+
+    /** Record s as the last uploaded sample */
+    void commit(const Sample &s, uint32_t now) {
+        last = s;
+        lastMs = now;
+        sent = true;
+    }
+
+    void setIntervals(uint32_t minMs, uint32_t maxMs) {
+        this->minMs = minMs;
+        this->maxMs = maxMs;
+    }
+
+private:
+    static uint32_t absDiff(int32_t a, int32_t b) { return a > b ? a - b : b - a; }
+    static uint32_t absDiff(uint32_t a, uint32_t b) { return a > b ? a - b : b - a; }
+
+    Deadband band;
+    uint32_t minMs, maxMs;
+    Sample last = {};
+    uint32_t lastMs = 0;
+    bool sent = false;
+};
@@ -0,0 +1,49 @@
+/**
+ *  @file WallClock.h
+ *  @brief Epoch timestamps for readings taken before SNTP has set the clock
+ *
+ *  Until the first sync time() counts from boot (and on across deep sleep), so early
+ *  readings carry small stamps that look like 1970. stamp() remembers the last of those;
+ *  the first synced stamp fixes the offset between the two timelines, and rebase() moves
+ *  the early stamps onto the epoch. Stamps below validFrom are "untimed" until then.
+ *  Not thread safe: the sketch guards it with a lock.
+ */
+#pragma once
+#include <stdint.h>
+
+class WallClock {
+public:
+    /** @param validFrom : time() above this means the clock has been synced [s] */
+    explicit WallClock(uint32_t validFrom) : validFrom(validFrom) {}
+
+    /** Timestamp for a reading taken now
+     *  @param raw : time(nullptr) [s]
+     *  @param ms  : millis() */
+    uint32_t stamp(uint32_t raw, uint32_t ms) {
+        if (raw < validFrom) {
+            lastRaw = raw;
+            lastMs = ms;
+            early = true;
+        } else if (!isSynced) {
+            // offset is only known if this boot saw the unsynced clock
+            offset = early ? raw - (lastRaw + (ms - lastMs) / 1000) : 0;
+            isSynced = true;
+        }
+        return raw;
+    }
+
+    /** True once a stamp has come from the synced clock */
+    bool synced() const { return isSynced; }
+
+    /** Stamp t on the epoch (unchanged if already timed, or not known yet) */
+    uint32_t rebase(uint32_t t) const { return t >= validFrom || !isSynced ? t : t + offset; }
+
+    bool timed(uint32_t t) const { return t >= validFrom; }
+
+private:
+    uint32_t validFrom;
+    uint32_t lastRaw = 0, lastMs = 0;   // last unsynced stamp and when it was taken
+    uint32_t offset = 0;                // synced minus unsynced time [s]
+    bool early = false;                 // an unsynced stamp was taken
+    bool isSynced = false;
+};
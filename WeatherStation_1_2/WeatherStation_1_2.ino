@@ -4,9 +4,43 @@
  *
  *  Author       : Ayush Chinmay
  *  Date Created : 11 August 2023
- *  Date Modified: 15 August 2023
+ *  Date Modified: 14 October 2026
  *
  * CHANGELOG:
+ *    * 14 October 2026
+ *            - Batch Firebase writes into a single multi-path update (FB_BATCH_UPLOAD)
+ *            - Move Firebase uploads to a queued FreeRTOS task (core 0 on dual-core parts)
+ *            - Buffer readings while offline and catch up in bulk under /BME280/history
+ *            - Store readings as packed 12-byte Samples, derive F/Bar/altitude on demand
+ *            - Read the BME280 with one I2C burst, optionally in forced mode (BME_FORCED_MODE)
+ *            - Refresh only the OLED fields that changed through partial page updates
+ *            - Configurable shared I2C clock (I2C_CLOCK_HZ) and per-device bus statistics
+ *            - Compile-time loop-stage profiler with latency histograms (PROFILE_ENABLE)
+ *            - Run sampling/display/upload from a deadline scheduler and sleep in between
+ *            - Deep-sleep duty-cycle mode with RTC-memory batching (LOW_POWER_MODE)
+ *            - Non-blocking WiFi manager with NVS-cached channel/BSSID/IP and backoff
+ *            - Cache the Firebase ID/refresh token in NVS to skip sign-in after a restart
+ *            - Keep the RTDB TLS session alive between uploads and count handshakes
+ *            - Deadband-triggered uploads with min-interval rate limit and heartbeat (station.deadband)
+ *            - Streaming 1 min / 10 min / 1 h min/max/mean/stddev summaries uploaded with each update
+ *            - Integer-only BME280 compensation (BME_INT_COMPENSATION), altitude from a lookup table
+ *            - Boot-time benchmark of the hot paths (BENCH_MODE) and a host-side harness in host/
+ *            - Copy the static OLED layout from a template; blit numeric fields with a 2x digit font
+ *            - const char* credentials, heap-free leveled logging (LOG_LEVEL), heap low-water reports
+ *            - Local HTTP/JSON endpoint with /latest and /history for LAN dashboards (LOCAL_HTTP)
+ *            - Fan new samples out to independently rated sinks (statistics, OLED, Serial, history, Firebase)
+ *            - Registry of additional BME280s (SENSOR_LIST, optional TCA9548A mux) polled as one pipeline,
+ *              uploaded under FB_ROOT/devices/<id> in the batch update; configurable station node FB_ROOT
+ *            - Per-channel software filter (running median, fixed-point EMA, decimation) ahead of the sinks;
+ *              BME280 hardware IIR now configurable (BME_HW_FILTER) and off by default
+ *            - constexpr station profiles (desk, battery, high-rate) for timing, oversampling and layout
+ *            - Live remote configuration of sample/display/upload rates and the unit from a FB_ROOT/config stream
+ *            - Segment-rotated LittleFS log behind the RAM history for multi-day outages (FB_FLASH_LOG)
+ *            - Server-timestamped pushes to FB_ROOT/log, serialized into a static arena (FB_LOG_PUSH)
+ *            - Task watchdog and a FB_ROOT/health node (heap/fragmentation, loop and upload latency, RSSI,
+ *              failure counts); a missing OLED no longer halts the station (HEALTH_WDT_S, HEALTH_PERIOD)
+ *            - Double-buffered OLED sent by a background task, I2C bus arbitrated per chunk (OLED_ASYNC)
+ *            - Dew point, absolute humidity, heat index and the 3 h pressure tendency on the OLED and in Firebase
  *    * 2 October 2023
  *            - Replace BME - 280 Sensor with BME280 Sensor
  *            - Updated Code to display pressure in Bars (Pa * E-5) instead of heatIndex
@@ -22,90 +56,544 @@
 
 /** ==========[ INCLUDES ]========== **/
 #include "config.h"
+#include "Log.h"
+#include "Aggregator.h"
+#include "BusArbiter.h"
+#if BENCH_MODE
+#include "Bench.h"
+#endif
+#include "Derived.h"
+#include "Filters.h"
+#include "FlashLog.h"
+#include "Health.h"
+#include "I2CStats.h"
+#include "JsonArena.h"
+#include "OfflineBacklog.h"
+#include "Profiler.h"
+#include "RemoteConfig.h"
+#include "RingBuffer.h"
+#include "Scheduler.h"
+#include "SensorRegistry.h"
+#include "Sinks.h"
+#include "UploadPolicy.h"
+#include "WallClock.h"
+#include "Sample.h"
+#include "SampleJson.h"
 #include <Wire.h>
 // I2C OLED
 #include <Adafruit_GFX.h>
 #include <Adafruit_SSD1306.h>
+#include "OledDirty.h"
+#include "OledFont.h"
 // BME Sensor
 #include <Adafruit_Sensor.h>
 #include <Adafruit_BME280.h>
+#include "BME280Burst.h"
 // Wifi
 #include <WiFi.h>
+#include "WifiManager.h"
+#include <WebServer.h>
+#include <WiFiClientSecure.h>
+#include <Preferences.h>
+#include <LittleFS.h>
 // Firebase database
 #include <Firebase_ESP_Client.h>
 #include "addons/TokenHelper.h" // Provide the token generation process info.
 #include "addons/RTDBHelper.h" // Provide the RTDB payload printing info and other helper functions.
+#include "TlsStats.h"
+// Watchdog
+#include <esp_task_wdt.h>
 
 /** ==========[ CONSTANTS ]========== **/
 // I2C OLED Display
-#define SCREEN_WIDTH 128
-#define SCREEN_HEIGHT 64
+constexpr int16_t oledWidth = station.screenWidth;
+constexpr int16_t oledHeight = station.screenHeight;
 #define OLED_RESET -1
 #define SCREEN_ADDRESS 0x3C
 
 // Wifi Credentials
-const String ssid = WIFI_SSID;                  // Replace with WiFi SSID
-const String pass = WIFI_PASS;                  // Replace WiFi Password
+constexpr const char *ssid = WIFI_SSID;                 // Replace with WiFi SSID
+constexpr const char *pass = WIFI_PASS;                 // Replace WiFi Password
 
 // Firebase Credentials
-const String api_key = API_KEY;                 // Replace with API Key
-const String firebase_host = FIREBASE_HOST;     // Replace with DataBase URL
-const String user_mail = AUTH_MAIL;             // Replace with User email
-const String user_pass = AUTH_PASS;             // Replace with User password
+constexpr const char *api_key = API_KEY;                // Replace with API Key
+constexpr const char *firebase_host = FIREBASE_HOST;    // Replace with DataBase URL
+constexpr const char *user_mail = AUTH_MAIL;            // Replace with User email
+constexpr const char *user_pass = AUTH_PASS;            // Replace with User password
 
 /** ==========[ VARIABLES ]========== **/
-// I2C OLED Display
-Adafruit_SSD1306 display(SCREEN_WIDTH, SCREEN_HEIGHT, &Wire, OLED_RESET);
+// I2C bus shared by OLED and BME280
+I2CStats oledBus, bmeBus;
+BusArbiter i2c;                         // loop() sensors and the OLED task take turns per transaction
+
+// I2C OLED Display (clock passed twice so it does not drop to 100 kHz after each transfer)
+Adafruit_SSD1306 display(oledWidth, oledHeight, &Wire, OLED_RESET, I2C_CLOCK_HZ, I2C_CLOCK_HZ);
+OledDirty<oledWidth, oledHeight> oledDirty;
+bool oledReady = false;                 // display.begin() succeeded; without it the station runs headless
+bool oledLayout = false;                // Static labels are on screen
+uint8_t oledTemplate[oledWidth * oledHeight / 8];    // Static labels, rendered once by initOled()
+volatile bool oledBusy = false;         // A frame is in flight (never with OLED_ASYNC 0)
+#if OLED_ASYNC
+// Double buffering: loop() draws into display.getBuffer() (the back buffer) and marks oledDirty;
+// oledPresent() hands a copy and its windows to the OLED task, which owns them while oledBusy
+uint8_t oledFront[oledWidth * oledHeight / 8];
+OledDirty<oledWidth, oledHeight> oledFrontDirty;
+TaskHandle_t oledTask = NULL;
+volatile unsigned long oledSkipped = 0; // Presents deferred because the previous frame was in flight
+#endif
+
+struct OledField {                      // Text field redrawn only when its contents change
+    int16_t x, y;
+    uint8_t size, chars;                // text size, max characters
+    char text[8];                       // text currently on screen
+};
+OledField oledHumid = { 42, 0, 2, 5, "" };
+OledField oledTemp = { 42, 24, 2, 5, "" };
+OledField oledUnit = { 108, 24, 2, 1, "" };
+OledField oledPress = { 42, 48, 2, 5, "" };
+OledField oledDew = { 24, 16, 1, 5, "" };       // size-1 rows between the readings: dew point, heat index,
+OledField oledHeat = { 84, 16, 1, 5, "" };      // 3 h pressure change and tendency
+OledField oledTrendChange = { 24, 40, 1, 5, "" };
+OledField oledTrend = { 66, 40, 1, 6, "" };
+const char *const oledTendency[] = { "", "fall++", "fall", "steady", "rise", "rise++" };   // PressureTendency
 
 // BME 280 sensor
 Adafruit_BME280 bme;
-#define SEALEVELPRESSURE_HPA (1013.25)
+BME280Burst bmeBurst;
+#if BME_FORCED_MODE && !BME_BURST_READ
+#error "BME_FORCED_MODE requires BME_BURST_READ"
+#endif
+#if BME_INT_COMPENSATION && !BME_BURST_READ
+#error "BME_INT_COMPENSATION requires BME_BURST_READ"
+#endif
+#define BME_HW_FILTER_COEFF (BME_HW_FILTER >= 16 ? Adafruit_BME280::FILTER_X16 : \
+                             BME_HW_FILTER >= 8 ? Adafruit_BME280::FILTER_X8 : \
+                             BME_HW_FILTER >= 4 ? Adafruit_BME280::FILTER_X4 : \
+                             BME_HW_FILTER >= 2 ? Adafruit_BME280::FILTER_X2 : Adafruit_BME280::FILTER_OFF)
+#define BME_SAMPLING(n) ((n) >= 16 ? Adafruit_BME280::SAMPLING_X16 : (n) >= 8 ? Adafruit_BME280::SAMPLING_X8 : \
+                         (n) >= 4 ? Adafruit_BME280::SAMPLING_X4 : (n) >= 2 ? Adafruit_BME280::SAMPLING_X2 : \
+                         Adafruit_BME280::SAMPLING_X1)
+
+// Additional sensors (config.h SENSOR_LIST) -- polled by loop(), the readings are shared with the uploader
+#define SENSOR_ONE(id, addr, mux) + 1
+#define SENSOR_COUNT (0 SENSOR_LIST(SENSOR_ONE))
+#if SENSOR_COUNT
+SensorRegistry<SENSOR_COUNT> sensors;
+Sample sensorShared[SENSOR_COUNT];
+portMUX_TYPE sensorLock = portMUX_INITIALIZER_UNLOCKED;
+#endif
+
+// WiFi connection
+WifiManager wifi;
+bool sntpStarted = false;
 
 // Firebase database
 FirebaseData fbdo;
 FirebaseAuth auth;
 FirebaseConfig config;
+TlsStats tls;                           // Session reuse of fbdo (uploader task only)
+#define FB_TOKEN_NAMESPACE "fbauth"
+#define FB_TIME_VALID 1600000000UL      // time(nullptr) above this means the clock has been synced
+uint32_t fbTokenExpires = 0;            // Expiry of the token last written to NVS [s]
+bool fbTokenCached = false;             // Session was resumed from the NVS token
+volatile bool fbSignIn = false;         // Cached token was rejected: sign in with credentials
+
+// Reading timestamps -- stamped by loop(), rebased by the uploader once SNTP has synced
+WallClock wallClock(FB_TIME_VALID);
+portMUX_TYPE clockLock = portMUX_INITIALIZER_UNLOCKED;
+
+// Log pushes -- a plain REST POST per record, written from static buffers (uploader task only)
+#if FB_LOG_PUSH
+#define FB_ID_TOKEN_MAX 1280            // Firebase ID tokens are ~1 KB JWTs
+WiFiClientSecure fbLogClient;           // Keep-alive session, separate from fbdo
+char fbIdToken[FB_ID_TOKEN_MAX];        // Copied once per token refresh, not per push
+char fbLogHead[FB_ID_TOKEN_MAX + 256];  // Request line and headers
+char fbLogBody[160];                    // One record, see sampleLogJson()
+RingBuffer<Sample, FB_LOG_BACKLOG> fbLogPending;   // failed pushes and replayed history, oldest first
+unsigned long fbLogFailed = 0;          // Log pushes that failed
+unsigned long fbLogLost = 0;            // Pending records overwritten before they were pushed
+#endif
+
+// Remote configuration -- parsed from the stream by the uploader task, applied by loop()
+#define REMOTE_CONFIG (ENABLE_FIREBASE && FB_REMOTE_CONFIG)
+#define RC_APPLY_MS 500                 // Pick-up latency of a pushed change [ms]
+#if REMOTE_CONFIG
+FirebaseData fbStream;                  // FB_ROOT/config stream: a stream needs its own session
+bool fbStreamOpen = false;
+unsigned long fbStreamRetry = 0;        // millis() of the last beginStream() attempt
+RemoteConfig rcPending;
+volatile bool rcFresh = false;
+portMUX_TYPE rcLock = portMUX_INITIALIZER_UNLOCKED;
+#endif
+int8_t unitMode = UNIT_ALTERNATE;       // UnitMode shown on the OLED
 
 // Measurement variables
-float humid, tempC, tempF, pressure, altitude;
+Sample reading;                         // Raw BME280 reading
+Sample latest;                          // Most recent reading after the software filter
 bool unitFlg = false;
-unsigned long fbTime = 0;
-unsigned long fbDelay = 10*60000;
-unsigned long oledTime = 0;
-unsigned long oledDelay = 2000;
-unsigned long bmeTime = 0;
-unsigned long bmeDelay = 41;
+constexpr unsigned long fbDelay = station.uploadMs;
+constexpr unsigned long oledDelay = station.displayMs;
+constexpr unsigned long bmeDelay = station.sampleMs;
+#if BME_FORCED_MODE
+static_assert(bme280MeasureMaxUs(station.osrsT, station.osrsP, station.osrsH) <= bmeDelay * 1000UL,
+              "forced conversion at this oversampling outlasts sampleMs: lower osrs or raise sampleMs");
+#endif
 unsigned long count = 0;
+volatile size_t fbBytes = 0;            // Payload size of the last upload [bytes]
+volatile unsigned long fbMillis = 0;    // Duration of the last upload [ms]
+
+// Low-power mode state, kept in RTC memory across deep sleep
+#if LOW_POWER_MODE
+#define LP_FLUSH_WAKES (fbDelay / bmeDelay > 0 ? fbDelay / bmeDelay : 1)   // Upload the RTC batch every N wakes
+#define LP_MAGIC 0x57534C50             // "WSLP": RTC contents are valid
+struct LowPowerState {
+    uint32_t magic;
+    uint32_t wakes;
+    uint16_t count;                     // samples in the batch
+    uint8_t channel;                    // last good WiFi channel (0 = scan)
+    uint8_t bssid[6];                   // last good access point
+    uint8_t osrs;                       // BME280 ctrl_meas oversampling bits
+    BME280Calib calib;
+    Sample samples[LP_BATCH];
+};
+RTC_DATA_ATTR LowPowerState lp;
+#endif
+
+// Window statistics -- updated by loop(), the closed windows are shared with the uploader
+#define AGG_LEVELS 3
+const uint16_t aggMultiples[AGG_LEVELS] = { 1, 10, 60 };     // x AGG_BASE_MS
+const char *const aggNames[AGG_LEVELS] = { "1m", "10m", "1h" };
+Aggregator<AGG_LEVELS> agg(AGG_BASE_MS, aggMultiples);
+WindowStats aggShared[AGG_LEVELS];     // last closed window of each level, not a queue
+volatile uint8_t aggFresh = 0;          // Levels closed since the last upload
+portMUX_TYPE aggLock = portMUX_INITIALIZER_UNLOCKED;
+
+// Pressure tendency -- fed by the closed 10 min windows in loop(), shared like aggShared
+#define TREND_LEVEL 1                   // aggregation level feeding the tendency (aggMultiples[1] = 10)
+#define TREND_WINDOWS (10800000UL / (AGG_BASE_MS * 10))     // windows spanning 3 h
+static_assert(TREND_WINDOWS >= 1 && TREND_WINDOWS < 255, "AGG_BASE_MS does not fit a 3 h tendency ring");
+PressureTrend<TREND_WINDOWS> pressureTrend;
+float trendChange = 0.0f;               // uploader copy [hPa / 3 h] (under aggLock)
+int8_t trendTendency = TREND_UNKNOWN;   // uploader copy, PressureTendency (under aggLock)
+
+// Software filter between readBME() and the sinks
+SampleFilter<ChannelFilter<FILTER_MEDIAN_TEMP, FILTER_EMA_TEMP>,
+             ChannelFilter<FILTER_MEDIAN_HUMID, FILTER_EMA_HUMID>,
+             ChannelFilter<FILTER_MEDIAN_PRESS, FILTER_EMA_PRESS>> sampleFilter(FILTER_DECIMATE);
+#if SENSOR_COUNT
+decltype(sampleFilter) sensorFilter[SENSOR_COUNT];     // same stages for the registry sensors, no decimation
+#endif
+
+// Periodic jobs
+Scheduler<SCHED_MAX_JOBS> sched;
+#if defined(ARDUINO_USB_CDC_ON_BOOT) && ARDUINO_USB_CDC_ON_BOOT
+#define SCHED_SLEEP 0                   // light sleep would drop the native USB serial ("USB CDC On Boot")
+#else
+#define SCHED_SLEEP SCHED_LIGHT_SLEEP
+#endif
+int8_t jobSample;
+
+// Firebase uploader task
+QueueHandle_t fbQueue = NULL;
+TaskHandle_t fbTask = NULL;
+unsigned long fbDropped = 0;            // Readings lost to a full queue or offline database (under dropLock)
+portMUX_TYPE dropLock = portMUX_INITIALIZER_UNLOCKED;  // bumped from loop() and the uploader task
+// Without station.deadband min = max = fbDelay, i.e. a plain fixed-interval upload
+UploadPolicy uploadPolicy({ FB_DEADBAND_TEMP, FB_DEADBAND_HUMID, FB_DEADBAND_PRESS },
+                          station.deadband ? FB_MIN_INTERVAL : fbDelay, fbDelay);
+
+// Offline history -- only touched by the uploader task
+OfflineBacklog<FB_HISTORY_CAPACITY> fbBacklog;     // RAM ring, then the flash log once that is full
+#if FB_FLASH_LOG
+FlashLog flashLog(FLASHLOG_SEGMENT_PAGES, FLASHLOG_MAX_SEGMENTS);
+bool flashLogReady = false;
+#endif
+#define FB_BACKLOG_CHUNK (FB_HISTORY_CHUNK > FB_FLASH_CHUNK ? FB_HISTORY_CHUNK : FB_FLASH_CHUNK)
+
+// Health metrics -- loop latency from loop(), upload results from the uploader task (see Health.h)
+#define HEALTH_ENABLE (ENABLE_FIREBASE && HEALTH_PERIOD)
+#if HEALTH_WDT_S
+#define WDT_FEED() esp_task_wdt_reset()
+#else
+#define WDT_FEED()
+#endif
+volatile uint32_t sensorErrors = 0;     // Invalid BME280 readings since boot
+#if HEALTH_ENABLE
+LatencyStats loopLatency;               // sched.runDue() per loop() [us]
+portMUX_TYPE healthLock = portMUX_INITIALIZER_UNLOCKED;
+UploadHealth uploadHealth;              // updateFB() attempts (uploader task only)
+SinkRate healthRate{ HEALTH_PERIOD };   // FB_ROOT/health report interval (uploader task only)
+#endif
+
+// Local HTTP endpoint -- served from loop(), so it shares latest and localHistory without locking
+#define NET_ENABLE (ENABLE_FIREBASE || LOCAL_HTTP)
+unsigned long latestMs = 0;             // millis() of the last valid sample
+#if LOCAL_HTTP
+WebServer http(LOCAL_HTTP_PORT);
+RingBuffer<Sample, LOCAL_HISTORY_CAPACITY> localHistory;
+#endif
+
+// Output sinks -- every new reading is offered to each in this order (see Sinks.h).
+// publish() never blocks; Firebase hands off to the uploader queue.
+void printBME(bool Fahren);             // defined below; the IDE's prototypes land after these structs
+bool queueFB(const Sample &s);
+void publishStats(uint8_t closed);
+
+struct StatsSink {                      // Window statistics: every valid sample
+    bool due(const Sample &s, uint32_t) { return sampleValid(s); }
+    void publish(const Sample &s, uint32_t now) {
+        uint8_t closed = agg.add(s, now);
+        if (closed & (1 << TREND_LEVEL)) {
+            pressureTrend.push(agg.last(TREND_LEVEL).ch[AGG_PRESS].mean);
+        }
+        if (closed) {
+            publishStats(closed);
+        }
+    }
+};
+
+struct OledSink {                       // Panel, alternating C / F
+    SinkRate rate{ (uint32_t)oledDelay };
+    bool due(const Sample &, uint32_t now) { return oledReady && rate.due(now); }
+    void publish(const Sample &, uint32_t now) {
+        rate.accept(now);
+        printBME(unitMode == UNIT_ALTERNATE ? unitFlg : unitMode == UNIT_F);
+        unitFlg = !unitFlg;
+    }
+};
+
+struct SerialSink {                     // Reading line at LOG_LEVEL_DEBUG
+    SinkRate rate{ (uint32_t)oledDelay };
+    bool due(const Sample &s, uint32_t now) { return LOG_LEVEL >= LOG_LEVEL_DEBUG && sampleValid(s) && rate.due(now); }
+    void publish(const Sample &s, uint32_t now) {
+        PROFILE_SCOPE(PROF_SERIAL);
+        rate.accept(now);
+        LOG_DEBUG(nullptr, "Humid: %.2f %%\t|\tTemp: %.1f C / %.1f F\t|\tPress: %.2f Bar\n",
+                  sampleHumid(s), sampleTempC(s), sampleTempF(s), sampleBar(s));
+    }
+};
+
+struct HistorySink {                    // Local HTTP history ring
+    SinkRate rate{ LOCAL_HISTORY_MS };
+    bool due(const Sample &s, uint32_t now) { return LOCAL_HTTP && sampleValid(s) && rate.due(now); }
+    void publish(const Sample &s, uint32_t now) {
+        rate.accept(now);
+#if LOCAL_HTTP
+        localHistory.push(s);
+#endif
+    }
+};
+
+struct FirebaseSink {                   // Uploader queue, paced by uploadPolicy
+    bool due(const Sample &s, uint32_t now) {
+        return ENABLE_FIREBASE && sampleValid(s) && uploadPolicy.due(s, now) != UploadPolicy::NONE;
+    }
+    void publish(const Sample &s, uint32_t now) {
+        if (queueFB(s)) {
+            uploadPolicy.commit(s, now);
+        }
+    }
+};
+
+StatsSink statsSink;
+OledSink oledSink;
+SerialSink serialSink;
+HistorySink historySink;
+FirebaseSink firebaseSink;
+SinkFanOut<StatsSink, OledSink, SerialSink, HistorySink, FirebaseSink>
+    sinks(statsSink, oledSink, serialSink, historySink, firebaseSink);
 
 
 /*  ==========[ SETUP ]========== */
 void setup() {
     // Initialize Serial Monitor
     Serial.begin(115200);  // Start serial communication
+    // Initialize I2C bus (GPIO21/22)
+    Wire.begin();
+    Wire.setClock(I2C_CLOCK_HZ);
+    i2c.begin();
+#if LOW_POWER_MODE
+    lowPowerCycle();        // takes one sample and deep-sleeps, never returns
+#endif
+    LOG_INFO("Reset reason: %s", resetReasonName());
+#if HEALTH_WDT_S
+    // Stretch the task watchdog before the uploader subscribes; loop() joins at the end of setup()
+    esp_task_wdt_init(HEALTH_WDT_S, true);
+#endif
     // Initialize OLED
     initOled();
+#if NET_ENABLE
     // Initialize Wifi
-        //initWifi();
+    initWifi();
+#endif
+#if ENABLE_FIREBASE
     // Initialize Firebase
-        //initFirebase();
+    initFirebase();
+  #if !BENCH_MODE
+    initUploader();
+  #endif
+#endif
+#if LOCAL_HTTP
+    initLocalHttp();
+#endif
     // Initialize BME
     initBME();
+#if SENSOR_COUNT
+    initSensors();
+#endif
+#if BENCH_MODE
+    benchAll();
+  #if ENABLE_FIREBASE
+    initUploader();         // only now: the upload benches share fbdo and the counters with the uploader task
+  #endif
+#endif
+    // Periodic jobs, run in this order when due together
+    jobSample = sched.add("sample", sampleJob, bmeDelay);     // also drives the output sinks
+#if SENSOR_COUNT
+    sched.add("sensors", sensorJob, SENSOR_POLL_MS);
+#endif
+#if NET_ENABLE
+    sched.add("wifi", wifiJob, WIFI_POLL_MS);
+#endif
+#if REMOTE_CONFIG
+    sched.add("config", configJob, RC_APPLY_MS);
+#endif
+#if LOCAL_HTTP
+    sched.add("http", httpJob, LOCAL_HTTP_POLL_MS);
+#endif
+#if I2C_STATS_PERIOD
+    sched.add("i2c", busStatsJob, I2C_STATS_PERIOD);
+#endif
+#if HEAP_STATS_PERIOD
+    sched.add("heap", heapJob, HEAP_STATS_PERIOD);
+#endif
+#if PROFILE_ENABLE
+    sched.add("profile", profileJob, PROFILE_PERIOD);
+#endif
+#if HEALTH_WDT_S
+    esp_task_wdt_add(NULL);             // a loop() that stops returning now reboots the station
+#endif
 }
 
 
 /*  ==========[ LOOP ]========== */
 void loop() {
-    // Get temperature event and print its value.
-    if (millis() - bmeTime >= bmeDelay || bmeTime == 0) {
-        bmeTime = millis();
-        readBME();
+    int64_t wait;
+    {
+        PROFILE_SCOPE(PROF_LOOP);
+#if HEALTH_ENABLE
+        uint32_t start = micros();
+        wait = sched.runDue();
+        uint32_t us = micros() - start;
+        portENTER_CRITICAL(&healthLock);
+        loopLatency.add(us);
+        portEXIT_CRITICAL(&healthLock);
+#else
+        wait = sched.runDue();
+#endif
     }
+    WDT_FEED();
+    // Without WiFi nothing else needs the CPU, so the chip can light-sleep between jobs
+    // (but not in the middle of a frame transfer)
+    sched.idle(wait, SCHED_SLEEP && !NET_ENABLE && !oledBusy);
+}
 
-    if (millis() - oledTime >= oledDelay || oledTime == 0) {
-        oledTime = millis();
-        printBME(unitFlg);
-        unitFlg = !unitFlg;
+
+/** ==========[ JOBS ]========== **
+ *  Scheduler entry points
+ */
+void sampleJob() {
+    if (!readBME()) {
+        return;                         // conversion still running: nothing new to fan out
+    }
+    if (!sampleValid(reading)) {
+        sensorErrors++;
+    }
+#if FILTER_ENABLE
+    if (!sampleFilter.push(reading, latest)) {
+        return;                         // decimated
+    }
+#else
+    latest = reading;
+#endif
+    uint32_t now = millis();
+    if (sampleValid(latest)) {
+        latestMs = now;
+    }
+    sinks.offer(latest, now);
+}
+
+#if SENSOR_COUNT
+void sensorJob() {
+    bool fresh;
+    {
+        BusLock bus(i2c);               // the mux channel must not change under the OLED task
+        fresh = sensors.poll(clockStamp());
+    }
+    if (!fresh) {
+        return;                         // first round, or a conversion is still running
+    }
+    Sample filtered[SENSOR_COUNT];
+    for (uint8_t i = 0; i < SENSOR_COUNT; i++) {
+#if FILTER_ENABLE
+        sensorFilter[i].push(sensors.entry(i).last, filtered[i]);
+#else
+        filtered[i] = sensors.entry(i).last;
+#endif
+    }
+    portENTER_CRITICAL(&sensorLock);
+    memcpy(sensorShared, filtered, sizeof(sensorShared));
+    portEXIT_CRITICAL(&sensorLock);
+    for (uint8_t i = 0; i < SENSOR_COUNT; i++) {
+        const SensorEntry &e = sensors.entry(i);
+        if (sampleValid(e.last)) {
+            LOG_DEBUG(e.name, "Humid: %.2f %%\t|\tTemp: %.1f C\t|\tPress: %.2f Bar",
+                      sampleHumid(e.last), sampleTempC(e.last), sampleBar(e.last));
+        }
+    }
+}
+#endif
+
+void wifiJob() {
+    wifi.poll();
+    if (!sntpStarted && wifi.connected()) {
+        configTime(0, 0, NTP_SERVER, NTP_SERVER2);      // keeps resyncing on its own from here on
+        sntpStarted = true;
+    }
+}
+
+#if REMOTE_CONFIG
+void configJob() {
+    if (!rcFresh) {
+        return;
     }
+    portENTER_CRITICAL(&rcLock);
+    RemoteConfig rc = rcPending;
+    rcPending = RemoteConfig();
+    rcFresh = false;
+    portEXIT_CRITICAL(&rcLock);
+    applyConfig(rc);
+}
+#endif
+
+#if LOCAL_HTTP
+void httpJob() {
+    http.handleClient();
+}
+#endif
+
+void busStatsJob() {
+    printBusStats(I2C_STATS_PERIOD);
+}
+
+void heapJob() {
+    printHeapStats();
+}
+
+void profileJob() {
+#if PROFILE_ENABLE
+    profileDump(Serial);
+#endif
 }
 
 
@@ -114,17 +602,17 @@ void loop() {
  */
 void initOled() {
     // I2C OLED SETUP
-    Serial.println("I2C OLED Test!");
+    LOG_INFO("I2C OLED Test!");
     if (!display.begin(SSD1306_SWITCHCAPVCC, SCREEN_ADDRESS)) {
-        Serial.println(F("SSD1306 allocation failed"));
-        for (;;)
-            ;  // Don't proceed, loop forever
+        LOG_ERROR("SSD1306 allocation failed, running without display");
+        return;                         // headless: sampling and uploads go on, the OLED sink stays off
     }
+    oledReady = true;
 
-    display.display();
+    oledDisplay();
     delay(1000);
     display.clearDisplay();
-    display.display();
+    oledDisplay();
     delay(1000);
 
     // DISPLAY TEXT
@@ -132,52 +620,79 @@ void initOled() {
     display.setTextColor(SSD1306_WHITE);  // Draw white text
     display.setCursor(0, 0);              // Start at top-left corner
     display.cp437(true);                  // Use full 256 char 'Code Page 437' font
+    renderLayout();
     delay(1000);
+#if OLED_ASYNC
+    // Below loop() and on its core: frames go out while loop() waits for the next job
+  #if CONFIG_FREERTOS_UNICORE
+    xTaskCreate(oledTaskLoop, "oled", OLED_TASK_STACK, NULL, tskIDLE_PRIORITY, &oledTask);
+  #else
+    xTaskCreatePinnedToCore(oledTaskLoop, "oled", OLED_TASK_STACK, NULL, tskIDLE_PRIORITY, &oledTask, 1);
+  #endif
+#endif
 }
 
 
-/** ==========[ INIT WIFI ]========== **
- *  Initialize WiFi
+/** ==========[ INIT BME ]========== **
+ *  Initialize BME-280 Sensor
  */
 void initBME() {
     // BME280 SETUP
-    Serial.println(F("BME 280 test!"));  // Print text to serial port
+    LOG_INFO("BME 280 test!");          // Print text to serial port
     bme.begin(0x76);                     // Initialize BME sensor
 
     // indoor navigation
-    Serial.println("-- Indoor Navigation Scenario --");
-    Serial.println("normal mode, 16x pressure / 2x temperature / 1x humidity oversampling,");
-    Serial.println("0.5ms standby period, filter 16x");
-    bme.setSampling(Adafruit_BME280::MODE_NORMAL,
-                    Adafruit_BME280::SAMPLING_X2,  // temperature
-                    Adafruit_BME280::SAMPLING_X16, // pressure
-                    Adafruit_BME280::SAMPLING_X1,  // humidity
-                    Adafruit_BME280::FILTER_X16,
+#if BME_FORCED_MODE
+    LOG_INFO("Indoor navigation: forced mode, %ux P / %ux T / %ux H oversampling, IIR filter %d, every %lu ms",
+             station.osrsP, station.osrsT, station.osrsH, BME_HW_FILTER, bmeDelay);
+#else
+    LOG_INFO("Indoor navigation: normal mode, %ux P / %ux T / %ux H oversampling, 0.5ms standby, IIR filter %d",
+             station.osrsP, station.osrsT, station.osrsH, BME_HW_FILTER);
+#endif
+    bme.setSampling(BME_FORCED_MODE ? Adafruit_BME280::MODE_FORCED : Adafruit_BME280::MODE_NORMAL,
+                    BME_SAMPLING(station.osrsT),
+                    BME_SAMPLING(station.osrsP),
+                    BME_SAMPLING(station.osrsH),
+                    BME_HW_FILTER_COEFF,           // smoothing is done in software (Filters.h)
                     Adafruit_BME280::STANDBY_MS_0_5 );
+
+#if BME_BURST_READ
+    if (!bmeBurst.begin(0x76, Wire, &bmeBus)) {
+        LOG_ERROR("Failed to read BME280 calibration!");
+    }
+#endif
+}
+
+
+/** ==========[ INIT SENSORS ]========== **
+ *  Register the SENSOR_LIST devices and set them up for forced mode
+ *  They share the bus accounting of the primary BME280.
+ */
+#if SENSOR_COUNT
+void initSensors() {
+#define SENSOR_ADD(id, addr, mux) sensors.add(id, addr, mux);
+    SENSOR_LIST(SENSOR_ADD)
+#undef SENSOR_ADD
+    uint8_t found = sensors.begin(Wire, &bmeBus, SENSOR_MUX_ADDR, BME_HW_FILTER);
+    LOG_INFO("Sensor registry: %u of %u found", found, (unsigned)sensors.size());
+    for (uint8_t i = 0; i < sensors.size(); i++) {
+        const SensorEntry &e = sensors.entry(i);
+        if (!e.present) {
+            LOG_ERROR("Sensor %s (0x%02X, mux %u) did not answer", e.name, e.addr, e.mux);
+        }
+    }
 }
+#endif
 
 
 /** ==========[ INIT WIFI ]========== **
  *  Initialize WiFi
+ *  Only loads the cached join hints; the connection itself is driven by the
+ *  "wifi" job so sampling and display keep running while the network is down.
  */
 void initWifi() {
-    // WIFI SETUP
-    WiFi.begin(ssid, pass);  // Connect to Wifi
-    Serial.print("[INFO] Connecting to WiFi");
-    while (WiFi.status() != WL_CONNECTED) {
-
-        display.clearDisplay();
-        display.setTextSize(1);
-        display.print("Connecting to WiFi...");
-        display.display();
-
-        Serial.print(".");
-        delay(1000);
-    }
-    Serial.print("[INFO] Connected with IP: "); Serial.println(WiFi.localIP());
-    display.clearDisplay();
-    display.print("WiFi Connected!");
-    display.display();
+    LOG_INFO("Connecting to WiFi");
+    wifi.begin(ssid, pass, WIFI_JOIN_TIMEOUT, WIFI_BACKOFF_MAX);
 }
 
 
@@ -186,123 +701,1454 @@ void initWifi() {
  */
 void initFirebase() {
     // Firebase Setup
-    Serial.printf("Firebase Client v%s\n", FIREBASE_CLIENT_VERSION);
+    LOG_INFO("Firebase Client v%s", FIREBASE_CLIENT_VERSION);
     config.host = firebase_host;
     config.api_key = api_key;
-    auth.user.email = user_mail;
-    auth.user.password = user_pass;
+    config.token_status_callback = fbTokenCallback;
 
-    config.token_status_callback = tokenStatusCallback;
+    fbTokenCached = FB_CACHE_TOKEN && restoreToken();
+    if (!fbTokenCached) {
+        auth.user.email = user_mail;
+        auth.user.password = user_pass;
+    }
 
     Firebase.begin(&config, &auth);
-    Firebase.reconnectWiFi(true);
+    Firebase.reconnectWiFi(false);     // reconnects are handled by WifiManager
     Firebase.setDoubleDigits(5);
+    // One long-lived session for all uploads: TCP keep-alive stops NAT/AP idle
+    // timeouts from silently killing it between fbDelay cycles
+    fbdo.keepAlive(FB_KEEPALIVE_IDLE, FB_KEEPALIVE_INTERVAL, FB_KEEPALIVE_COUNT);
+}
+
+
+/** ==========[ INIT LOCAL HTTP ]========== **
+ *  Serve the latest sample and the local history as JSON on the LAN
+ *    GET /latest                        {"time":..,"temperature":..,"humidity":..,"pressure":..,"age":ms}
+ *    GET /history[?since=T][&limit=N]   [{...}, ...] oldest first, LOCAL_HISTORY_MS apart
+ *  Polled by the "http" job; requests are answered as soon as WiFi is up. Times are epoch
+ *  seconds once the clock has synced (rebased, see clockStamp()), seconds since boot before.
+ */
+#if LOCAL_HTTP
+void initLocalHttp() {
+    http.on("/latest", HTTP_GET, httpLatest);
+    http.on("/history", HTTP_GET, httpHistory);
+    http.onNotFound([] { httpError(404, "not found"); });
+    http.begin();
+    LOG_INFO("Local HTTP on port %u", (unsigned)LOCAL_HTTP_PORT);
+}
+
+void httpError(int code, const char *reason) {
+    char buf[64];
+    int n = snprintf(buf, sizeof(buf), "{\"error\":\"%s\"}", reason);
+    http.send_P(code, "application/json", buf, n);
+}
+
+/** ==========[ HTTP LATEST ]========== **
+ *  Most recent reading plus its age, from the same Sample the uploader sends
+ */
+void httpLatest() {
+    if (!sampleValid(latest)) {
+        httpError(503, "no reading");
+        return;
+    }
+    Sample s = latest;
+    s.time = clockRebase(s.time);
+    char buf[128];
+    int n = sampleJson(buf, sizeof(buf), s) - 1;           // reopen the object
+    n += snprintf(buf + n, sizeof(buf) - n, ",\"age\":%lu}", millis() - latestMs);
+    http.sendHeader("Access-Control-Allow-Origin", "*");
+    http.sendHeader("Cache-Control", "no-store");
+    http.send_P(200, "application/json", buf, n);
+}
+
+/** ==========[ HTTP HISTORY ]========== **
+ *  Stream localHistory as a chunked JSON array, LOCAL_HTTP_CHUNK bytes at a time
+ *  @arg since : only samples newer than this epoch [s]
+ *  @arg limit : at most this many samples
+ */
+void httpHistory() {
+    uint32_t since = http.hasArg("since") ? strtoul(http.arg("since").c_str(), nullptr, 10) : 0;
+    size_t limit = http.hasArg("limit") ? strtoul(http.arg("limit").c_str(), nullptr, 10) : localHistory.size();
+
+    size_t first = 0;
+    while (first < localHistory.size() && clockRebase(localHistory.peek(first).time) <= since) {
+        first++;
+    }
+    size_t last = localHistory.size() - first > limit ? first + limit : localHistory.size();
+
+    http.sendHeader("Access-Control-Allow-Origin", "*");
+    http.setContentLength(CONTENT_LENGTH_UNKNOWN);
+    http.send(200, "application/json", "");
+
+    char buf[LOCAL_HTTP_CHUNK];
+    size_t used = 0;
+    buf[used++] = '[';
+    for (size_t i = first; i < last; i++) {
+        if (used + 96 > sizeof(buf)) {                      // one record is < 96 bytes
+            http.sendContent(buf, used);
+            used = 0;
+        }
+        if (i > first) {
+            buf[used++] = ',';
+        }
+        Sample s = localHistory.peek(i);
+        s.time = clockRebase(s.time);
+        used += sampleJson(buf + used, sizeof(buf) - used, s);
+    }
+    buf[used++] = ']';
+    http.sendContent(buf, used);
+    http.sendContent("");                                   // end of the chunked response
+}
+#endif
+
+
+#if LOW_POWER_MODE
+/** ==========[ LOW POWER CYCLE ]========== **
+ *  One deep-sleep duty cycle: sample, append to the RTC batch, flush every
+ *  LP_FLUSH_WAKES wakes (or when the batch is full), then sleep again.
+ *  The OLED is switched off and the BME280 keeps its configuration between wakes,
+ *  so only the first (cold) boot talks to the sensor through Adafruit_BME280.
+ */
+void lowPowerCycle() {
+    if (lp.magic != LP_MAGIC) {
+        memset(&lp, 0, sizeof(lp));
+        lp.magic = LP_MAGIC;
+        if (display.begin(SSD1306_SWITCHCAPVCC, SCREEN_ADDRESS)) {
+            display.ssd1306_command(SSD1306_DISPLAYOFF);
+        }
+        // weather monitoring: forced mode, no filter (one sample per wake)
+        bme.begin(0x76);
+        bme.setSampling(Adafruit_BME280::MODE_FORCED,
+                        BME_SAMPLING(station.osrsT),
+                        BME_SAMPLING(station.osrsP),
+                        BME_SAMPLING(station.osrsH),
+                        Adafruit_BME280::FILTER_OFF);
+        bmeBurst.begin(0x76, Wire, &bmeBus);
+        lp.calib = bmeBurst.calibration();
+        lp.osrs = bmeBurst.oversampling();
+    } else {
+        bmeBurst.restore(0x76, lp.calib, lp.osrs, Wire, &bmeBus);
+        bmeBurst.trigger();
+    }
+
+    unsigned long start = millis();
+    delay(2);
+    while (bmeBurst.measuring() && millis() - start < 50) {
+        delay(1);
+    }
+    Sample s;
+    if (burstSample(s)) {
+        if (lp.count == LP_BATCH) {     // flushes kept failing: drop the oldest sample
+            memmove(lp.samples, lp.samples + 1, (LP_BATCH - 1) * sizeof(Sample));
+            lp.count--;
+        }
+        lp.samples[lp.count++] = s;
+    }
+
+    lp.wakes++;
+    if (lp.count > 0 && (lp.wakes % LP_FLUSH_WAKES == 0 || lp.count == LP_BATCH)) {
+        lowPowerFlush();
+    }
+
+    unsigned long awake = millis();
+    LOG_INFO("Wake %lu: %u samples buffered, awake %lu ms", (unsigned long)lp.wakes, (unsigned)lp.count, awake);
+    Serial.flush();
+    uint64_t sleepMs = awake < bmeDelay ? bmeDelay - awake : 1;
+    esp_sleep_enable_timer_wakeup(sleepMs * 1000ULL);
+    esp_deep_sleep_start();
+}
+
+
+/** ==========[ LOW POWER FLUSH ]========== **
+ *  Bring the radio up just long enough to upload the whole RTC batch in one request
+ *  The system time survives deep sleep, so only the first flush waits for SNTP; it then
+ *  rebases the batch in RTC memory. Without a sync the batch is kept for the next flush.
+ *  @return true if the batch was acknowledged and cleared
+ */
+bool lowPowerFlush() {
+    bool ok = false;
+    clockStamp();                       // last unsynced time, the reference for the rebase
+    if (lowPowerConnect() && lowPowerSync()) {
+        initFirebase();
+        unsigned long start = millis();
+        while (!Firebase.ready() && millis() - start < LP_FB_TIMEOUT) {
+            checkSignIn();
+            delay(10);
+        }
+
+        if (Firebase.ready()) {
+            FirebaseJson json;
+            for (uint16_t i = 0; i < lp.count; i++) {
+                addHistoryJson(json, lp.samples[i], "history/");
+            }
+            addLiveJson(json, lp.samples[lp.count - 1]);
+            ok = tls.run(fbdo, [&] { return Firebase.RTDB.updateNode(&fbdo, F(FB_ROOT), &json); });
+            if (ok) {
+                count += lp.count;
+                lp.count = 0;
+            } else {
+                LOG_ERROR("Firebase batch upload failed: %s", fbdo.errorReason().c_str());
+            }
+        }
+    }
+    WiFi.disconnect(true);
+    WiFi.mode(WIFI_OFF);
+    return ok;
+}
+
+
+/** ==========[ LOW POWER CONNECT ]========== **
+ *  Join WiFi using the channel/BSSID cached in RTC memory and an optional static IP,
+ *  which skips the scan and DHCP. A failed fast join clears the cache so the next
+ *  flush does a full scan.
+ */
+bool lowPowerConnect() {
+    WiFi.persistent(false);
+    WiFi.mode(WIFI_STA);
+
+    IPAddress ip, gateway, subnet, dns;
+    if (ip.fromString(LP_STATIC_IP) && gateway.fromString(LP_GATEWAY) &&
+        subnet.fromString(LP_SUBNET) && dns.fromString(LP_DNS)) {
+        WiFi.config(ip, gateway, subnet, dns);
+    }
+    if (lp.channel) {
+        WiFi.begin(ssid, pass, lp.channel, lp.bssid, true);
+    } else {
+        WiFi.begin(ssid, pass);
+    }
+
+    unsigned long start = millis();
+    while (WiFi.status() != WL_CONNECTED && millis() - start < LP_WIFI_TIMEOUT) {
+        delay(10);
+    }
+    if (WiFi.status() != WL_CONNECTED) {
+        LOG_ERROR("WiFi connection timed out");
+        lp.channel = 0;
+        return false;
+    }
+    lp.channel = WiFi.channel();
+    memcpy(lp.bssid, WiFi.BSSID(), sizeof(lp.bssid));
+    LOG_INFO("WiFi up in %lu ms", millis() - start);
+    return true;
+}
+
+
+/** ==========[ LOW POWER SYNC ]========== **
+ *  Start SNTP, wait up to LP_NTP_TIMEOUT for a valid clock and move the batch onto the epoch
+ *  @return false if the clock is still unsynced
+ */
+bool lowPowerSync() {
+    configTime(0, 0, NTP_SERVER, NTP_SERVER2);
+    unsigned long start = millis();
+    while ((uint32_t)time(nullptr) < FB_TIME_VALID && millis() - start < LP_NTP_TIMEOUT) {
+        delay(10);
+    }
+    clockStamp();
+    if (!clockSynced()) {
+        LOG_ERROR("SNTP sync timed out, batch kept");
+        return false;
+    }
+    for (uint16_t i = 0; i < lp.count; i++) {
+        lp.samples[i].time = clockRebase(lp.samples[i].time);
+    }
+    return true;
+}
+#endif
+
+
+/** ==========[ INIT UPLOADER ]========== **
+ *  Start the Firebase uploader task
+ *  Pinned to core 0 on dual-core parts so the network stack never stalls loop() on core 1;
+ *  single-core parts (ESP32-S2) run it below the loop() priority instead.
+ */
+void initUploader() {
+#if FB_FLASH_LOG
+    flashLogReady = LittleFS.begin(true) && flashLog.begin(LittleFS);     // formats an unformatted partition
+    if (flashLogReady) {
+        fbBacklog.attach(&flashLog);
+        LOG_INFO("Flash log: %lu readings pending", (unsigned long)flashLog.size());
+    } else {
+        LOG_ERROR("Flash log unavailable, offline buffering is RAM only");
+    }
+#endif
+    fbQueue = xQueueCreate(FB_QUEUE_DEPTH, sizeof(Sample));
+#if CONFIG_FREERTOS_UNICORE
+    xTaskCreate(uploadTask, "fbUpload", FB_TASK_STACK, NULL, tskIDLE_PRIORITY, &fbTask);
+#else
+    xTaskCreatePinnedToCore(uploadTask, "fbUpload", FB_TASK_STACK, NULL, 1, &fbTask, 0);
+#endif
+}
+
+
+/** ==========[ RESTORE TOKEN ]========== **
+ *  Resume the Firebase session from the token cached in NVS
+ *  With a synced clock (e.g. after deep sleep) a still-valid ID token is used as is;
+ *  otherwise it is marked expired so the library goes straight to the refresh token.
+ *  @return true if a cached session was handed to the library
+ */
+bool restoreToken() {
+    Preferences prefs;
+    if (!prefs.begin(FB_TOKEN_NAMESPACE, true)) {
+        return false;
+    }
+    String id = prefs.getString("id");
+    String refresh = prefs.getString("refresh");
+    uint32_t expires = prefs.getUInt("expires");
+    prefs.end();
+    if (refresh.length() == 0) {
+        return false;
+    }
+
+    uint32_t now = time(nullptr);
+    size_t remaining = (now > FB_TIME_VALID && expires > now + 60) ? expires - now : 1;
+    Firebase.setIdToken(&config, id.c_str(), remaining, refresh.c_str());
+    fbTokenExpires = expires;
+    LOG_INFO("Firebase token restored (%s)", remaining > 1 ? "valid" : "refresh");
+    return true;
+}
+
+
+/** ==========[ TOKEN CALLBACK ]========== **
+ *  Token status hook: log through TokenHelper and keep the NVS copy current
+ */
+void fbTokenCallback(TokenInfo info) {
+    tokenStatusCallback(info);
+#if FB_LOG_PUSH
+    if (info.status == token_status_ready) {
+        fbIdToken[0] = '\0';            // new token: pushLog() copies it on its next request
+    }
+#endif
+#if FB_CACHE_TOKEN
+    if (info.status == token_status_ready) {
+        uint32_t expires = config.signer.tokens.expires;
+        if (expires < FB_TIME_VALID) {
+            expires = time(nullptr) + 3600;     // ID tokens live one hour
+        }
+        if (expires == fbTokenExpires) {
+            return;                             // already cached
+        }
+        Preferences prefs;
+        if (prefs.begin(FB_TOKEN_NAMESPACE, false)) {
+            prefs.putString("id", Firebase.getToken());
+            prefs.putString("refresh", Firebase.getRefreshToken());
+            prefs.putUInt("expires", expires);
+            prefs.end();
+            fbTokenExpires = expires;
+        }
+    } else if (info.status == token_status_error && fbTokenCached) {
+        Preferences prefs;
+        if (prefs.begin(FB_TOKEN_NAMESPACE, false)) {
+            prefs.clear();
+            prefs.end();
+        }
+        fbTokenCached = false;
+        fbSignIn = true;
+    }
+#endif
+}
+
+
+/** ==========[ CHECK SIGN-IN ]========== **
+ *  Fall back to email/password sign-in once a cached token has been rejected
+ *  Called from the task that drives Firebase.ready(), never from the callback itself.
+ */
+void checkSignIn() {
+    if (!fbSignIn) {
+        return;
+    }
+    fbSignIn = false;
+    LOG_INFO("Cached Firebase token rejected, signing in");
+    auth.user.email = user_mail;
+    auth.user.password = user_pass;
+    Firebase.begin(&config, &auth);
 }
 
 
 /** ==========[ PRINT BME ]========== **
  *  Print BME-280 Sensor Data to OLED Display
+ *  Only fields whose text changed are redrawn, and only their pages/columns are sent.
+ *  The full frame is pushed when the static layout has to be drawn again.
  *  @param Fahren : Print Temperature in Fahrenheit
  */
 void printBME(bool Fahren) {
-    display.clearDisplay();
-    display.setCursor(0, 0);
-
-    if (isnan(humid) || isnan(tempC)) {
-        Serial.println(F("[ERROR] Failed to read from BME Sensor!"));
+    PROFILE_SCOPE(PROF_DISPLAY);
+    if (!sampleValid(latest)) {
+        LOG_ERROR("Failed to read from BME Sensor!");
+        display.clearDisplay();
+        display.setCursor(0, 0);
+        display.setTextSize(1);
         display.write("Failed to read BME");
-        display.display();
-        delay(1000);
+        oledDirty.mark(0, 0, oledWidth, oledHeight);
+        oledPresent();
+        oledLayout = false;
         return;
     }
 
-     display.clearDisplay();
-     //  display.display();
-
-    Serial.print("Humid: "); Serial.print(humid); Serial.print(" %");
+    bool full = !oledLayout;
+    if (full) {
+        drawLayout();
+    }
 
-    display.print("Humid: ");
-    display.setTextSize(2);
-    display.print(humid, 1);
-    display.setTextSize(1);
+    float humid = sampleHumid(latest);
+    float temp = Fahren ? sampleTempF(latest) : sampleTempC(latest);
+    float pressure = sampleBar(latest);
 
-    display.print(" ");
-    display.setTextSize(2);
-    display.print(" %");
-    display.setTextSize(1);
-    display.print("\n\n\nTemp:  ");
-
-    if (Fahren == true) {
-        Serial.print("\t|\tTemp: "); Serial.print(tempF, 1); Serial.print(" F");
-        Serial.print("\t|\tPress: "); Serial.print(pressure, 1); Serial.println(" hPa\n");
-    
-        display.setTextSize(2);
-        display.print(tempF, 1);
-        display.setTextSize(1);
-        display.print("  o");
-        display.setTextSize(2);
-        display.print("F");
+    char buf[8];
+    snprintf(buf, sizeof(buf), "%.1f", humid);
+    drawField(oledHumid, buf);
+    snprintf(buf, sizeof(buf), "%.1f", temp);
+    drawField(oledTemp, buf);
+    drawField(oledUnit, Fahren ? "F" : "C");
+    snprintf(buf, sizeof(buf), "%.2f", pressure);
+    drawField(oledPress, buf);
 
-        display.setTextSize(1);
-        display.print("\n\n\nPress: ");
-        display.setTextSize(2);
-        display.print(pressure, 2);
-        display.setTextSize(1);
-        // display.print("h");
-        // display.setTextSize(2);
-        display.print("  Bar \n");
-        display.setTextSize(1);
+    DerivedMetrics d = deriveMetrics(latest);                   // in the unit of the temperature row
+    snprintf(buf, sizeof(buf), "%.1f", Fahren ? celsiusToF(d.dewPointC) : d.dewPointC);
+    drawField(oledDew, buf);
+    snprintf(buf, sizeof(buf), "%.1f", Fahren ? celsiusToF(d.heatIndexC) : d.heatIndexC);
+    drawField(oledHeat, buf);
+    if (pressureTrend.ready()) {
+        snprintf(buf, sizeof(buf), "%+.1f", pressureTrend.change());
     } else {
-        Serial.print("\t|\tTemp: "); Serial.print(tempC, 1); Serial.print(" C");
-        Serial.print("\t|\tPress: "); Serial.print(pressure, 2); Serial.println(" C\n");
+        strcpy(buf, "--");
+    }
+    drawField(oledTrendChange, buf);
+    drawField(oledTrend, oledTendency[pressureTrend.tendency()]);
 
-        display.setTextSize(2);
-        display.print(tempC, 1);
-        display.setTextSize(1);
-        display.print("  o");
-        display.setTextSize(2);
-        display.print("C");
+    if (full) {
+        oledDirty.mark(0, 0, oledWidth, oledHeight);
+    }
+    oledPresent();
+}
 
-        display.setTextSize(1);
-        display.print("\n\n\nPress: ");
-        display.setTextSize(2);
-        display.print(pressure, 2);
-        display.setTextSize(1);
-        // display.print("h");
-        // display.setTextSize(2);
-        display.print("  Bar \n");
-        display.setTextSize(1);
+
+/** ==========[ OLED PRESENT ]========== **
+ *  Send the dirty windows of the back buffer to the panel
+ *  With OLED_ASYNC the back buffer is copied to oledFront and the OLED task sends it, so
+ *  loop() only pays for a 1 KB memcpy. While the previous frame is still in flight the
+ *  marks stay in oledDirty and go out, merged, with the next refresh: the panel skips a
+ *  frame rather than loop() waiting for the bus.
+ */
+void oledPresent() {
+    if (!oledDirty.dirty()) {
+        return;
+    }
+#if OLED_ASYNC
+    if (oledTask) {
+        if (oledBusy) {
+            oledSkipped++;
+            return;
+        }
+        memcpy(oledFront, display.getBuffer(), sizeof(oledFront));
+        oledFrontDirty = oledDirty;
+        oledDirty.clear();
+        oledBusy = true;
+        xTaskNotifyGive(oledTask);
+        return;
     }
+#endif
+    uint32_t start = micros();
+    size_t n = oledDirty.flush(display.getBuffer(), display, Wire, SCREEN_ADDRESS, i2c);
+    oledBus.add(n, micros() - start);
+}
+
+
+/** ==========[ OLED TASK ]========== **
+ *  Send every frame handed over by oledPresent() from the front buffer
+ *  The bus is taken per address window and OLED_WIRE_CHUNK, so a sensor read in loop()
+ *  waits behind one chunk at most. oledBus books the wall time of the whole transfer,
+ *  including the gaps where loop() had the bus.
+ */
+#if OLED_ASYNC
+void oledTaskLoop(void *param) {
+    for (;;) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        uint32_t start = micros();
+        size_t n = oledFrontDirty.flush(oledFront, display, Wire, SCREEN_ADDRESS, i2c);
+        oledBus.add(n, micros() - start);
+        oledBusy = false;
+    }
+}
+#endif
+
+
+/** ==========[ OLED DISPLAY ]========== **
+ *  Push the full framebuffer and account for it on the bus
+ */
+void oledDisplay() {
+    BusLock bus(i2c);
+    uint32_t start = micros();
     display.display();
-    // delay(500);
+    oledBus.add(oledWidth * oledHeight / 8, micros() - start);
+}
+
+/** Wait until the OLED task has sent the frame in flight (returns at once without OLED_ASYNC) */
+void oledWait() {
+    while (oledBusy) {
+        delay(1);
+    }
+}
+
+
+/** ==========[ RENDER LAYOUT ]========== **
+ *  Draw the static labels once through GFX and keep the framebuffer as a template
+ */
+void renderLayout() {
+    display.clearDisplay();
+    display.setTextSize(1);
+    display.setCursor(0, 0);    display.print("Humid: ");
+    display.setCursor(0, 24);   display.print("Temp:  ");
+    display.setCursor(102, 24); display.print("o");
+    display.setCursor(0, 48);   display.print("Press: ");
+    display.setCursor(102, 48); display.print("Bar");
+    display.setCursor(0, 16);   display.print("Dew");
+    display.setCursor(66, 16);  display.print("HI");
+    display.setCursor(0, 40);   display.print("3h");
+    display.setTextSize(2);
+    display.setCursor(108, 0);  display.print("%");
+    memcpy(oledTemplate, display.getBuffer(), sizeof(oledTemplate));
+    display.clearDisplay();
+}
+
+
+/** ==========[ DRAW LAYOUT ]========== **
+ *  Copy the static labels from the template and invalidate all fields
+ */
+void drawLayout() {
+    memcpy(display.getBuffer(), oledTemplate, sizeof(oledTemplate));
+    oledHumid.text[0] = oledTemp.text[0] = oledUnit.text[0] = oledPress.text[0] = '\0';
+    oledDew.text[0] = oledHeat.text[0] = oledTrendChange.text[0] = oledTrend.text[0] = '\0';
+    oledLayout = true;
+}
+
+
+/** ==========[ DRAW FIELD ]========== **
+ *  Redraw a field into the framebuffer if its text changed and mark it dirty
+ *  @param f    : Field to update
+ *  @param text : New contents
+ */
+void drawField(OledField &f, const char *text) {
+    if (strncmp(f.text, text, sizeof(f.text)) == 0) {
+        return;
+    }
+    int16_t w = f.chars * 6 * f.size;
+    int16_t h = 8 * f.size;
+    if (f.size != 2 || (f.y & 7) ||
+        !oledBlit2x(display.getBuffer(), oledWidth, f.x, f.y / 8, text, f.chars)) {
+        display.fillRect(f.x, f.y, w, h, SSD1306_BLACK);     // not blittable: draw through GFX
+        display.setTextSize(f.size);
+        display.setCursor(f.x, f.y);
+        display.print(text);
+    }
+    oledDirty.mark(f.x, f.y, w, h);
+
+    strncpy(f.text, text, sizeof(f.text) - 1);
+    f.text[sizeof(f.text) - 1] = '\0';
+}
+
+/** ==========[ PRINT BUS STATS ]========== **
+ *  Print I2C usage per device and waits for the bus arbiter since the last call
+ *  @param window : Elapsed time covered by the report [ms]
+ */
+void printBusStats(unsigned long window) {
+    static I2CStats oledPrev, bmePrev;
+    I2CStats o = oledBus.since(oledPrev);
+    I2CStats b = bmeBus.since(bmePrev);
+    oledPrev = oledBus;
+    bmePrev = bmeBus;
+
+    LOG_DEBUG("I2C", "%lu Hz | oled: %lu txn, %lu B, %lu us (%.2f%%) | bme: %lu txn, %lu B, %lu us (%.2f%%)",
+                  (unsigned long)I2C_CLOCK_HZ,
+                  (unsigned long)o.txns, (unsigned long)o.bytes, (unsigned long)o.us, o.us / (window * 10.0f),
+                  (unsigned long)b.txns, (unsigned long)b.bytes, (unsigned long)b.us, b.us / (window * 10.0f));
+
+    static uint32_t locksPrev, contendedPrev, waitPrev;
+    uint32_t locks = i2c.locks, contended = i2c.contended, waitUs = i2c.waitUs;
+#if OLED_ASYNC
+    LOG_DEBUG("I2C", "arbiter: %lu locks, %lu waited, %lu us | oled frames deferred %lu",
+              (unsigned long)(locks - locksPrev), (unsigned long)(contended - contendedPrev),
+              (unsigned long)(waitUs - waitPrev), (unsigned long)oledSkipped);
+#else
+    LOG_DEBUG("I2C", "arbiter: %lu locks, %lu waited, %lu us",
+              (unsigned long)(locks - locksPrev), (unsigned long)(contended - contendedPrev),
+              (unsigned long)(waitUs - waitPrev));
+#endif
+    locksPrev = locks;
+    contendedPrev = contended;
+    waitPrev = waitUs;
+}
+
+/** ==========[ PRINT HEAP STATS ]========== **
+ *  Report free heap, its low-water mark since boot and the largest free block
+ *  A low-water mark that keeps falling is a leak; a largest block far below the free
+ *  total is fragmentation (the TLS client needs ~16 KB contiguous to reconnect).
+ */
+void printHeapStats() {
+#if ENABLE_FIREBASE
+    LOG_DEBUG("HEAP", "free %lu B, min %lu B, largest %lu B | uploader stack left %lu B",
+              (unsigned long)ESP.getFreeHeap(), (unsigned long)ESP.getMinFreeHeap(),
+              (unsigned long)ESP.getMaxAllocHeap(),
+              (unsigned long)(fbTask ? uxTaskGetStackHighWaterMark(fbTask) * sizeof(StackType_t) : 0));
+#else
+    LOG_DEBUG("HEAP", "free %lu B, min %lu B, largest %lu B",
+              (unsigned long)ESP.getFreeHeap(), (unsigned long)ESP.getMinFreeHeap(),
+              (unsigned long)ESP.getMaxAllocHeap());
+#endif
 }
 
 /** ==========[ READ BME ]========== **
- *  Read BME-280 Sensor Data
+ *  Read BME-280 Sensor Data into reading
+ *  In forced mode the result of the previous trigger is read and the next conversion
+ *  started right away, so the sensor converts (and then sleeps) between two calls.
+ *  sampleMs is checked against the datasheet maximum conversion time at compile time; if a
+ *  conversion still outlasts bmeDelay the tick is skipped and reading is kept. PROF_PERIOD
+ *  marks real samples only, so skips show up as doubled periods.
+ *  @return false if the tick was skipped (reading unchanged)
  */
-void readBME() {
+bool readBME() {
+    PROFILE_SCOPE(PROF_SAMPLE);
+    BusLock bus(i2c);                   // waits behind at most one OLED chunk
+#if BME_BURST_READ
+  #if BME_FORCED_MODE
+    if (bmeBurst.measuring()) {
+        return false;
+    }
+  #endif
+    PROFILE_MARK(PROF_PERIOD);
+    if (!burstSample(reading)) {
+        reading = makeSample(clockStamp(), NAN, NAN, NAN);
+    }
+  #if BME_FORCED_MODE
+    bmeBurst.trigger();
+  #endif
+#else
+    PROFILE_MARK(PROF_PERIOD);
+    float humid, tempC, pressure;
+    uint32_t start = micros();
     humid = bme.readHumidity();                         // [%]
     tempC = bme.readTemperature();                      // [C]
-    tempF = (tempC * 9/5.0) + 32.0;                     // [F]
-    pressure = bme.readPressure() / 100000.0F;          // [Bar]
-    altitude = bme.readAltitude(SEALEVELPRESSURE_HPA);  // [m]
-    // updateFB();
+    pressure = bme.readPressure();                      // [Pa]
+    bmeBus.add(14, micros() - start);                   // 3 + 3+3 + 3+2 data bytes read by the library
+    reading = makeSample(clockStamp(), tempC, humid, pressure);
+#endif
+    return true;
+}
+
+/** ==========[ BURST SAMPLE ]========== **
+ *  One burst read of the data registers, compensated into a Sample
+ *  With BME_INT_COMPENSATION the fixed-point channels come straight from the
+ *  datasheet integer formulas; no float math runs per sample.
+ *  @return false on a bus error (s is left untouched)
+ */
+bool burstSample(Sample &s) {
+#if BME_INT_COMPENSATION
+    int16_t temp;
+    uint16_t humid;
+    uint32_t pressure;
+    if (!bmeBurst.readInt(temp, humid, pressure)) {     // [0.01 C], [0.01 %], [Pa]
+        return false;
+    }
+    s.time = clockStamp();
+    s.temp = temp;                                      // Sample is packed: no references into it
+    s.humid = humid;
+    s.pressure = pressure;
+#else
+    float tempC, humid, pressure;
+    if (!bmeBurst.read(tempC, humid, pressure)) {       // [C], [%], [Pa]
+        return false;
+    }
+    s = makeSample(clockStamp(), tempC, humid, pressure);
+#endif
+    return true;
+}
+
+
+/** ==========[ CLOCK ]========== **
+ *  Timestamp of a reading taken now; before the first SNTP sync it counts from boot
+ *  and is moved onto the epoch later by clockRebase() (see WallClock)
+ */
+uint32_t clockStamp() {
+    uint32_t raw = (uint32_t)time(nullptr);
+    uint32_t ms = millis();
+    portENTER_CRITICAL(&clockLock);
+    bool was = wallClock.synced();
+    uint32_t t = wallClock.stamp(raw, ms);
+    bool now = wallClock.synced();
+    portEXIT_CRITICAL(&clockLock);
+    if (now && !was) {
+        LOG_INFO("Clock synced: %lu", (unsigned long)t);
+    }
+    return t;
+}
+
+/** Epoch of a stamp taken by clockStamp(); still below FB_TIME_VALID while the clock is unsynced */
+uint32_t clockRebase(uint32_t t) {
+    portENTER_CRITICAL(&clockLock);
+    t = wallClock.rebase(t);
+    portEXIT_CRITICAL(&clockLock);
+    return t;
+}
+
+bool clockSynced() {
+    portENTER_CRITICAL(&clockLock);
+    bool synced = wallClock.synced();
+    portEXIT_CRITICAL(&clockLock);
+    return synced;
+}
+
+
+/** ==========[ PUBLISH STATS ]========== **
+ *  Hand freshly closed windows and the pressure tendency to the uploader
+ *  @param closed : Bitmask of the levels that closed
+ */
+void publishStats(uint8_t closed) {
+    portENTER_CRITICAL(&aggLock);
+    for (uint8_t l = 0; l < AGG_LEVELS; l++) {
+        if (closed & (1 << l)) {
+            aggShared[l] = agg.last(l);
+        }
+    }
+    aggFresh |= closed;
+    trendChange = pressureTrend.change();
+    trendTendency = pressureTrend.tendency();
+    portEXIT_CRITICAL(&aggLock);
+}
+
+
+/** ==========[ QUEUE FIREBASE ]========== **
+ *  Hand a reading to the uploader task (see FirebaseSink)
+ *  Never blocks: if the queue is full the reading is dropped and counted.
+ *  @return true if the reading was queued
+ */
+bool queueFB(const Sample &s) {
+    PROFILE_SCOPE(PROF_QUEUE);
+    if (fbQueue == NULL || !sampleValid(s)) {
+        return false;
+    }
+
+    if (xQueueSend(fbQueue, &s, 0) != pdTRUE) {
+        countDropped(1);
+        return false;
+    }
+    return true;
+}
+
+/** ==========[ DROPPED READINGS ]========== **
+ *  fbDropped is bumped from both cores: every update and read goes through dropLock
+ */
+void countDropped(unsigned long n) {
+    portENTER_CRITICAL(&dropLock);
+    fbDropped += n;
+    portEXIT_CRITICAL(&dropLock);
+}
+
+unsigned long droppedReadings() {
+    portENTER_CRITICAL(&dropLock);
+    unsigned long n = fbDropped;
+    portEXIT_CRITICAL(&dropLock);
+    return n;
+}
+
+/** ==========[ QUEUE DEPTH ]========== **
+ *  Number of readings waiting for the uploader task
+ */
+unsigned int fbQueueDepth() {
+    return fbQueue ? uxQueueMessagesWaiting(fbQueue) : 0;
+}
+
+
+/** ==========[ UPLOAD TASK ]========== **
+ *  Drain the reading queue and push each record to Firebase
+ *  Readings that cannot be delivered go to fbBacklog: the RAM ring, and the flash log once
+ *  that is full. When the database is reachable again the backlog is streamed out oldest
+ *  first, chunk after chunk while no live reading is waiting.
+ *  Nothing is uploaded before the clock has synced: readings are held in the backlog and
+ *  rebased onto the epoch at upload, so no history key is a boot-relative time.
+ *  With FB_LOG_PUSH the pending log records (failed pushes, replayed history) follow.
+ *  Firebase.ready() is polled while idle so token refreshes keep running. The task feeds
+ *  the watchdog once per wakeup and per backlog chunk.
+ */
+void uploadTask(void *param) {
+    Sample r;
+#if HEALTH_WDT_S
+    esp_task_wdt_add(NULL);
+#endif
+    for (;;) {
+        bool got = xQueueReceive(fbQueue, &r, pdMS_TO_TICKS(1000)) == pdTRUE;
+        WDT_FEED();
+        checkSignIn();
+        bool online = Firebase.ready();
+        bool timed = clockSynced();
+
+        if (got && timed) {
+            r.time = clockRebase(r.time);
+        }
+        if (got && !(online && timed && updateFB(r)) && !fbBacklog.store(r)) {
+            countDropped(1);
+        }
+        while (online && timed && !fbBacklog.empty() && !fbQueueDepth() && flushBacklog()) {
+            WDT_FEED();
+        }
+#if FB_LOG_PUSH
+        while (online && !fbLogPending.empty() && !fbQueueDepth() && retryLog()) {
+            WDT_FEED();
+        }
+#endif
+#if REMOTE_CONFIG
+        if (online) {
+            pollConfigStream();
+        }
+#endif
+#if HEALTH_ENABLE
+        if (online && healthRate.due(millis())) {
+            healthRate.accept(millis());
+            publishHealth();
+        }
+#endif
+#if FB_PING_MS
+        // Idle ping so the server does not close the session before the next upload
+        if (!got && online && millis() - tls.lastRequest >= FB_PING_MS) {
+            tls.run(fbdo, [] { return Firebase.RTDB.getShallowData(&fbdo, F(FB_ROOT "/humidity")); });
+        }
+#endif
+    }
+}
+
+
+/** ==========[ CONFIG STREAM ]========== **
+ *  Follow FB_ROOT/config on a second FirebaseData, signed in through the same config/auth
+ *  Called from the uploader task. readStream() returns at once unless an event is arriving,
+ *  so there is no polling traffic; the server pushes the whole node on connect, then
+ *  each change as it is made.
+ */
+#if REMOTE_CONFIG
+void pollConfigStream() {
+    if (!fbStreamOpen) {
+        if (fbStreamRetry && millis() - fbStreamRetry < FB_STREAM_RETRY_MS) {
+            return;
+        }
+        fbStreamRetry = millis();
+        fbStreamOpen = Firebase.RTDB.beginStream(&fbStream, F(FB_ROOT "/config"));
+        if (!fbStreamOpen) {
+            LOG_ERROR("Config stream failed: %s", fbStream.errorReason().c_str());
+        }
+        return;
+    }
+    if (!Firebase.RTDB.readStream(&fbStream)) {
+        LOG_ERROR("Config stream lost: %s", fbStream.errorReason().c_str());
+        fbStreamOpen = false;
+        return;
+    }
+    if (!fbStream.streamAvailable()) {
+        return;                         // keep-alive or timeout; the library resumes the stream itself
+    }
+
+    RemoteConfig rc;
+    String path = fbStream.dataPath();
+    String type = fbStream.dataType();
+    if (type == "json" && path == "/") {
+        FirebaseJson &json = fbStream.jsonObject();
+        FirebaseJsonData d;
+        static const char *const keys[] = { "sampleMs", "displayMs", "uploadMs" };
+        for (const char *key : keys) {
+            if (json.get(d, key) && d.success) {
+                rc.set(key, d.intValue);
+            }
+        }
+        if (json.get(d, "unit") && d.success) {
+            rc.setUnit(d.stringValue.c_str());
+        }
+    } else if (type == "int") {
+        rc.set(path.c_str() + 1, fbStream.intData());
+    } else if (type == "string" && path == "/unit") {
+        rc.setUnit(fbStream.stringData().c_str());
+    }
+    if (rc.empty()) {
+        if (type != "null") {           // node absent or deleted: keep the current settings
+            LOG_ERROR("Config stream: ignored %s (%s)", path.c_str(), type.c_str());
+        }
+        return;
+    }
+    portENTER_CRITICAL(&rcLock);
+    rcPending.merge(rc);
+    rcFresh = true;
+    portEXIT_CRITICAL(&rcLock);
+}
+
+/** ==========[ APPLY CONFIG ]========== **
+ *  Retune the jobs and sinks to a remote update (loop() only, like everything it touches)
+ */
+void applyConfig(const RemoteConfig &rc) {
+    if (rc.sampleMs != RC_UNSET) {
+        sched.setPeriod(jobSample, rc.sampleMs);
+    }
+    if (rc.displayMs != RC_UNSET) {
+        oledSink.rate.period = rc.displayMs;
+        serialSink.rate.period = rc.displayMs;
+    }
+    if (rc.uploadMs != RC_UNSET) {
+        uploadPolicy.setIntervals(station.deadband ? FB_MIN_INTERVAL : rc.uploadMs, rc.uploadMs);
+    }
+    if (rc.unit != RC_UNSET) {
+        unitMode = rc.unit;
+    }
+    LOG_INFO("Remote config: sample %ld ms, display %ld ms, upload %ld ms, unit %d (-1: unchanged)",
+             (long)rc.sampleMs, (long)rc.displayMs, (long)rc.uploadMs, rc.unit);
+}
+#endif
+
+
+/** ==========[ FLUSH BACKLOG ]========== **
+ *  Upload the oldest buffered readings in a single request: up to FB_HISTORY_CHUNK from
+ *  RAM, or FB_FLASH_CHUNK from the flash log once RAM has drained
+ *  Records are keyed by timestamp under FB_ROOT/history, so a retried chunk overwrites
+ *  itself instead of duplicating; the backlog only advances after the acknowledgement.
+ *  Called once the clock has synced: stamps from before are rebased, and the few that cannot
+ *  be (left from a boot that never synced) are dropped.
+ *  @return true if the chunk was acknowledged and removed from the backlog
+ */
+bool flushBacklog() {
+    Sample buf[FB_BACKLOG_CHUNK];
+    bool ram = fbBacklog.inRam();
+    size_t n = fbBacklog.peek(buf, ram ? FB_HISTORY_CHUNK : FB_FLASH_CHUNK);
+    if (n == 0) {
+        return false;
+    }
+    FirebaseJson json;
+    size_t timed = 0;
+    for (size_t i = 0; i < n; i++) {
+        buf[i].time = clockRebase(buf[i].time);
+        if (buf[i].time >= FB_TIME_VALID) {
+            addHistoryJson(json, buf[i], "");
+            timed++;
+        }
+    }
+    if (timed == 0) {
+        countDropped(n);
+        fbBacklog.consume(n);
+        return true;
+    }
+
+    unsigned long start = millis();
+    if (!tls.run(fbdo, [&] { return Firebase.RTDB.updateNode(&fbdo, F(FB_ROOT "/history"), &json); })) {
+        LOG_ERROR("Firebase history upload failed: %s", fbdo.errorReason().c_str());
+        return false;
+    }
+    fbBacklog.consume(n);
+    countDropped(n - timed);
+    count += timed;
+#if FB_LOG_PUSH
+    for (size_t i = 0; i < n; i++) {
+        if (buf[i].time >= FB_TIME_VALID) {
+            queueLog(buf[i]);           // replayed readings reach the log as well, see retryLog()
+        }
+    }
+#endif
+    LOG_INFO("Firebase history (%s): %u records, %lu ms, %u left",
+             ram ? "RAM" : "flash", (unsigned)timed, millis() - start, (unsigned)fbBacklog.size());
+    return true;
+}
+
+
+/** ==========[ HISTORY JSON ]========== **
+ *  Add one history record keyed by its timestamp
+ *  @param prefix : Path of the history node relative to the update target
+ */
+void addHistoryJson(FirebaseJson &json, const Sample &s, const char *prefix) {
+    char key[48];
+    snprintf(key, sizeof(key), "%s%lu/humidity", prefix, (unsigned long)s.time);
+    json.set(key, sampleHumid(s));
+    snprintf(key, sizeof(key), "%s%lu/temperature/C", prefix, (unsigned long)s.time);
+    json.set(key, sampleTempC(s));
+    snprintf(key, sizeof(key), "%s%lu/Pressure", prefix, (unsigned long)s.time);
+    json.set(key, sampleBar(s));
+}
+
+
+/** ==========[ LIVE JSON ]========== **
+ *  Add the live /BME280 nodes for a sample
+ */
+void addLiveJson(FirebaseJson &json, const Sample &s) {
+    json.set("humidity", sampleHumid(s));
+    json.set("temperature/C", sampleTempC(s));
+    json.set("temperature/F", sampleTempF(s));
+    json.set("Pressure", sampleBar(s));
+    json.set("Altitude", sampleAltitude(s, station.seaLevelHPa));
+    addDerivedJson(json, s);
+}
+
+
+/** ==========[ DERIVED JSON ]========== **
+ *  Add dew point, heat index, absolute humidity and, once 3 h of windows have closed,
+ *  the pressure tendency: O(1), nothing is re-read from the history
+ */
+void addDerivedJson(FirebaseJson &json, const Sample &s) {
+    DerivedMetrics d = deriveMetrics(s);
+    json.set("dewPoint/C", d.dewPointC);
+    json.set("dewPoint/F", celsiusToF(d.dewPointC));
+    json.set("heatIndex/C", d.heatIndexC);
+    json.set("heatIndex/F", celsiusToF(d.heatIndexC));
+    json.set("absHumidity", d.absHumidity);
+
+    portENTER_CRITICAL(&aggLock);
+    float change = trendChange;
+    int8_t tendency = trendTendency;
+    portEXIT_CRITICAL(&aggLock);
+    if (tendency != TREND_UNKNOWN) {
+        json.set("pressureTrend/hPa3h", change);
+        json.set("pressureTrend/tendency", tendencyName(tendency));
+    }
+}
+
+
+/** ==========[ STATS JSON ]========== **
+ *  Add the window summaries closed since the last upload under stats/<window>
+ *  They ride along with the live update, so they cost no extra request. Each node is a
+ *  "latest window" snapshot, overwritten as windows close: with uploads slower than a base
+ *  window (or while offline) only the last closed 1 min window reaches the database.
+ *  @return bitmask of the levels added
+ */
+uint8_t addStatsJson(FirebaseJson &json) {
+    WindowStats w[AGG_LEVELS];
+    portENTER_CRITICAL(&aggLock);
+    uint8_t fresh = aggFresh;
+    memcpy(w, aggShared, sizeof(w));
+    portEXIT_CRITICAL(&aggLock);
+
+    static const char *const chNames[AGG_CHANNELS] = { "temperature", "humidity", "Pressure" };
+    char key[48];
+    for (uint8_t l = 0; l < AGG_LEVELS; l++) {
+        if (!(fresh & (1 << l))) {
+            continue;
+        }
+        snprintf(key, sizeof(key), "stats/%s/start", aggNames[l]);
+        json.set(key, (int)clockRebase(w[l].start));
+        snprintf(key, sizeof(key), "stats/%s/n", aggNames[l]);
+        json.set(key, (int)w[l].ch[AGG_TEMP].n);
+        for (uint8_t c = 0; c < AGG_CHANNELS; c++) {
+            const Welford &st = w[l].ch[c];
+            snprintf(key, sizeof(key), "stats/%s/%s/min", aggNames[l], chNames[c]);
+            json.set(key, st.lo);
+            snprintf(key, sizeof(key), "stats/%s/%s/max", aggNames[l], chNames[c]);
+            json.set(key, st.hi);
+            snprintf(key, sizeof(key), "stats/%s/%s/mean", aggNames[l], chNames[c]);
+            json.set(key, st.mean);
+            snprintf(key, sizeof(key), "stats/%s/%s/stddev", aggNames[l], chNames[c]);
+            json.set(key, st.stddev());
+        }
+    }
+    return fresh;
+}
+
+
+/** ==========[ DEVICES JSON ]========== **
+ *  Add the latest reading of every registered sensor under devices/<id>
+ *  Same channel layout as the station node, in the same request.
+ */
+void addDevicesJson(FirebaseJson &json) {
+#if SENSOR_COUNT
+    Sample s[SENSOR_COUNT];
+    portENTER_CRITICAL(&sensorLock);
+    memcpy(s, sensorShared, sizeof(s));
+    portEXIT_CRITICAL(&sensorLock);
+
+    char key[48];
+    for (uint8_t i = 0; i < SENSOR_COUNT; i++) {
+        if (!sampleValid(s[i])) {
+            continue;
+        }
+        const char *id = sensors.entry(i).name;     // set in setup(), read-only afterwards
+        snprintf(key, sizeof(key), "devices/%s/humidity", id);
+        json.set(key, sampleHumid(s[i]));
+        snprintf(key, sizeof(key), "devices/%s/temperature/C", id);
+        json.set(key, sampleTempC(s[i]));
+        snprintf(key, sizeof(key), "devices/%s/temperature/F", id);
+        json.set(key, sampleTempF(s[i]));
+        snprintf(key, sizeof(key), "devices/%s/Pressure", id);
+        json.set(key, sampleBar(s[i]));
+    }
+#endif
 }
 
 
 /** ==========[ UPDATE FIREBASE ]========== **
  *  Send data to firebase
+ *  With FB_BATCH_UPLOAD all readings go out as one multi-path PATCH on FB_ROOT,
+ *  keeping the same node layout as the individual writes. The registry sensors
+ *  ride along under devices/, next to the derived metrics (both in one extra PATCH
+ *  without FB_BATCH_UPLOAD).
+ *  @param r : Sample to upload
+ *  @return true if the database acknowledged the write
  */
-void updateFB() {
-    if (Firebase.ready() && (millis() - fbTime > fbDelay || fbTime == 0)) {
-        fbTime = millis();
+bool updateFB(const Sample &r) {
+    PROFILE_SCOPE(PROF_UPLOAD);
+    bool ok = true;
+    unsigned long start;
+#if FB_BATCH_UPLOAD
+    FirebaseJson json;
+    addLiveJson(json, r);
+    addDevicesJson(json);
+    uint8_t stats = addStatsJson(json);
+    fbBytes = json.serializedBufferLength();
+
+    start = millis();
+    ok = tls.run(fbdo, [&] { return Firebase.RTDB.updateNode(&fbdo, F(FB_ROOT), &json); });
+    if (ok && stats) {
+        portENTER_CRITICAL(&aggLock);
+        aggFresh &= ~stats;
+        portEXIT_CRITICAL(&aggLock);
+    }
+#else
+    start = millis();
+    ok &= tls.run(fbdo, [&] { return Firebase.RTDB.setFloat(&fbdo, F(FB_ROOT "/humidity"), sampleHumid(r)); });
+    ok &= tls.run(fbdo, [&] { return Firebase.RTDB.setFloat(&fbdo, F(FB_ROOT "/temperature/C"), sampleTempC(r)); });
+    ok &= tls.run(fbdo, [&] { return Firebase.RTDB.setFloat(&fbdo, F(FB_ROOT "/temperature/F"), sampleTempF(r)); });
+    ok &= tls.run(fbdo, [&] { return Firebase.RTDB.setFloat(&fbdo, F(FB_ROOT "/Pressure"), sampleBar(r)); });
+    ok &= tls.run(fbdo, [&] { return Firebase.RTDB.setFloat(&fbdo, F(FB_ROOT "/Altitude"), sampleAltitude(r, station.seaLevelHPa)); });
+    FirebaseJson extra;                 // derived metrics, the registry sensors and closed windows
+    addDerivedJson(extra, r);
+    addDevicesJson(extra);
+    uint8_t stats = addStatsJson(extra);
+    bool sent = tls.run(fbdo, [&] { return Firebase.RTDB.updateNode(&fbdo, F(FB_ROOT), &extra); });
+    if (sent && stats) {
+        portENTER_CRITICAL(&aggLock);
+        aggFresh &= ~stats;
+        portEXIT_CRITICAL(&aggLock);
+    }
+    ok &= sent;
+    fbBytes = 0;    // not tracked for individual writes
+#endif
+    fbMillis = millis() - start;
+#if HEALTH_ENABLE
+    uploadHealth.add(ok, fbMillis);
+#endif
+
+    if (!ok) {
+        LOG_ERROR("Firebase update failed: %s", fbdo.errorReason().c_str());
+        return false;
+    }
+    LOG_INFO("Firebase upload #%lu: %u bytes, %lu ms | queue %u, dropped %lu | tls %lu/%lu new, last %lu ms",
+                  count, (unsigned)fbBytes, fbMillis, fbQueueDepth(), droppedReadings(),
+                  (unsigned long)tls.handshakes, (unsigned long)tls.requests, (unsigned long)tls.lastHandshakeMs);
+    count++;
+#if FB_LOG_PUSH
+    logReading(r);                      // the live update stands; a failed push is retried on its own
+#endif
+    return true;
+}
 
-        Firebase.RTDB.setFloat(&fbdo, F("/BME280/humidity"), humid);
-        Firebase.RTDB.setFloat(&fbdo, F("/BME280/temperature/C"), tempC);
-        Firebase.RTDB.setFloat(&fbdo, F("/BME280/temperature/F"), tempF);
-        Firebase.RTDB.setFloat(&fbdo, F("/BME280/Pressure"), pressure);
-        Firebase.RTDB.setFloat(&fbdo, F("/BME280/Altitude"), altitude);
 
-        count++;
+/** ==========[ PUSH LOG ]========== **
+ *  POST one record to FB_ROOT/log.json; the database assigns a push ID and fills in
+ *  "ts" with its own clock ({".sv":"timestamp"}), so the log keeps every reading with a
+ *  trustworthy time even if the device clock is off.
+ *  The body is built by sampleLogJson() in fbLogBody and the request head with one
+ *  snprintf() in fbLogHead: no FirebaseJson tree and no heap use per record. The TLS
+ *  session is kept alive between pushes like fbdo's.
+ *  @return true if the database answered 200
+ */
+#if FB_LOG_PUSH
+bool pushLog(const Sample &s) {
+    JsonArena body(fbLogBody, sizeof(fbLogBody));
+    sampleLogJson(body, s);
+    if (!fbIdToken[0]) {
+        strlcpy(fbIdToken, Firebase.getToken().c_str(), sizeof(fbIdToken));
+    }
+    int n = snprintf(fbLogHead, sizeof(fbLogHead),
+                     "POST " FB_ROOT "/log.json?auth=%s HTTP/1.1\r\nHost: %s\r\n"
+                     "Content-Type: application/json\r\nContent-Length: %u\r\nConnection: keep-alive\r\n\r\n",
+                     fbIdToken, firebase_host, (unsigned)body.size());
+    if (!body.ok() || n <= 0 || (size_t)n >= sizeof(fbLogHead)) {
+        LOG_ERROR("Firebase log push: request does not fit its buffer");
+        return false;
+    }
+
+    if (!fbLogClient.connected()) {
+        fbLogClient.setInsecure();      // like fbdo, which runs without a CA certificate
+        fbLogClient.setTimeout(FB_LOG_TIMEOUT);
+        if (!fbLogClient.connect(firebase_host, 443)) {
+            LOG_ERROR("Firebase log push: connection failed");
+            return false;
+        }
+    }
+    fbLogClient.write((const uint8_t *)fbLogHead, n);
+    fbLogClient.write((const uint8_t *)body.data(), body.size());
+
+    int status = readLogResponse();
+    if (status != 200) {
+        LOG_ERROR("Firebase log push failed: HTTP %d", status);
+        if (status == 401) {
+            fbIdToken[0] = '\0';        // expired between refreshes: take the current one next time
+        }
+        return false;
+    }
+    return true;
+}
+
+/** ==========[ LOG READING ]========== **
+ *  Push an uploaded reading to the log, or queue it behind the records still pending
+ *  The log is separate from the live update: a failed push only queues the record in
+ *  fbLogPending for retryLog(), it never sends the reading to the offline history.
+ */
+void logReading(const Sample &s) {
+    if (fbLogPending.empty() && pushLog(s)) {
+        return;
+    }
+    if (fbLogPending.empty()) {
+        fbLogFailed++;
+    }
+    queueLog(s);
+}
+
+/** Keep a record for a later push; a full queue loses its oldest record */
+void queueLog(const Sample &s) {
+    if (!fbLogPending.push(s)) {
+        fbLogLost++;
+    }
+}
+
+/** Push the oldest pending record
+ *  @return true if it was acknowledged */
+bool retryLog() {
+    if (!pushLog(fbLogPending.peek(0))) {
+        fbLogFailed++;
+        return false;
+    }
+    fbLogPending.pop(1);
+    return true;
+}
+
+/** Read the status line, skip the headers and drain the body ({"name":"<push id>"})
+ *  The session is closed if the server asks for it or the length is unknown.
+ *  @return HTTP status, 0 on a timeout
+ */
+int readLogResponse() {
+    char line[96];
+    size_t n = fbLogClient.readBytesUntil('\n', line, sizeof(line) - 1);
+    line[n] = '\0';
+    int status = n > 12 && !strncmp(line, "HTTP/1.1 ", 9) ? atoi(line + 9) : 0;
+
+    long length = -1;
+    bool close = status == 0;
+    while (!close) {
+        n = fbLogClient.readBytesUntil('\n', line, sizeof(line) - 1);
+        line[n] = '\0';
+        if (n == 0 || line[0] == '\r') {
+            break;                      // blank line: end of headers
+        }
+        if (!strncasecmp(line, "Content-Length:", 15)) {
+            length = atol(line + 15);
+        } else if (!strncasecmp(line, "Connection: close", 17)) {
+            close = true;
+        }
+    }
+    close |= length < 0;
+    while (length > 0) {
+        size_t got = fbLogClient.readBytes(line, length < (long)sizeof(line) ? length : sizeof(line));
+        if (got == 0) {
+            close = true;
+            break;
+        }
+        length -= got;
+    }
+    if (close) {
+        fbLogClient.stop();
+    }
+    return status;
+}
+#endif
+
+
+/** ==========[ PUBLISH HEALTH ]========== **
+ *  Overwrite FB_ROOT/health with a compact snapshot (uploader task, every HEALTH_PERIOD)
+ *    { "uptime": s, "reset": "poweron", "count": uploads, "rssi": dBm, "oled": true,
+ *      "heap": { "free", "min", "largest", "frag": % }, "stackLeft": B,
+ *      "loop": { "maxUs", "meanUs" }, "upload": { "ok", "failed", "pct", "lastMs", "maxMs", "meanMs" },
+ *      "dropped", "backlog", "sensorErrors", "log": { "failed", "lost", "pending" }, "ts": server time [ms] }
+ *  Max, mean and pct cover the interval since the previous report; counts run since boot.
+ *  A "ts" that stops advancing marks a unit that went silent.
+ *  @return true if the database acknowledged the write (the window restarts only then)
+ */
+#if HEALTH_ENABLE
+bool publishHealth() {
+    portENTER_CRITICAL(&healthLock);
+    LatencyStats loopWin = loopLatency;
+    portEXIT_CRITICAL(&healthLock);
+    uint32_t heapFree = ESP.getFreeHeap();
+    uint32_t heapLargest = ESP.getMaxAllocHeap();
+    uint32_t backlog = fbBacklog.size();
+
+    FirebaseJson json;
+    json.set("uptime", (int)(millis() / 1000));
+    json.set("reset", resetReasonName());
+    json.set("count", (int)count);
+    json.set("rssi", (int)WiFi.RSSI());
+    json.set("oled", oledReady);
+    json.set("heap/free", (int)heapFree);
+    json.set("heap/min", (int)ESP.getMinFreeHeap());
+    json.set("heap/largest", (int)heapLargest);
+    json.set("heap/frag", (int)heapFragmentation(heapFree, heapLargest));
+    json.set("stackLeft", (int)(uxTaskGetStackHighWaterMark(NULL) * sizeof(StackType_t)));
+    json.set("loop/maxUs", (int)loopWin.max);
+    json.set("loop/meanUs", (int)loopWin.mean());
+    json.set("upload/ok", (int)uploadHealth.ok);
+    json.set("upload/failed", (int)uploadHealth.failed);
+    json.set("upload/pct", (int)uploadHealth.successPct());
+    json.set("upload/lastMs", (int)uploadHealth.ms.last);
+    json.set("upload/maxMs", (int)uploadHealth.ms.max);
+    json.set("upload/meanMs", (int)uploadHealth.ms.mean());
+    json.set("dropped", (int)droppedReadings());
+  #if FB_LOG_PUSH
+    json.set("log/failed", (int)fbLogFailed);
+    json.set("log/lost", (int)fbLogLost);
+    json.set("log/pending", (int)fbLogPending.size());
+  #endif
+    json.set("backlog", (int)backlog);
+    json.set("sensorErrors", (int)sensorErrors);
+    json.set("ts/.sv", "timestamp");
+
+    if (!tls.run(fbdo, [&] { return Firebase.RTDB.updateNode(&fbdo, F(FB_ROOT "/health"), &json); })) {
+        LOG_ERROR("Firebase health update failed: %s", fbdo.errorReason().c_str());
+        return false;
+    }
+    portENTER_CRITICAL(&healthLock);
+    loopLatency.reset();
+    portEXIT_CRITICAL(&healthLock);
+    uploadHealth.reset();
+    LOG_DEBUG("HEALTH", "heap %lu B (%u%% fragmented) | loop max %lu us | rssi %d dBm | uploads %lu ok, %lu failed",
+              (unsigned long)heapFree, (unsigned)heapFragmentation(heapFree, heapLargest), (unsigned long)loopWin.max,
+              (int)WiFi.RSSI(), (unsigned long)uploadHealth.ok, (unsigned long)uploadHealth.failed);
+    return true;
+}
+#endif
+
+/** ==========[ RESET REASON ]========== **
+ *  Short name of the last reset cause; "taskwdt" is a stall caught by the watchdog
+ */
+const char *resetReasonName() {
+    switch (esp_reset_reason()) {
+    case ESP_RST_POWERON:   return "poweron";
+    case ESP_RST_EXT:       return "external";
+    case ESP_RST_SW:        return "software";
+    case ESP_RST_PANIC:     return "panic";
+    case ESP_RST_INT_WDT:   return "intwdt";
+    case ESP_RST_TASK_WDT:  return "taskwdt";
+    case ESP_RST_WDT:       return "wdt";
+    case ESP_RST_DEEPSLEEP: return "deepsleep";
+    case ESP_RST_BROWNOUT:  return "brownout";
+    default:                return "unknown";
+    }
+}
+
+
+/** ==========[ BENCHMARK ]========== **
+ *  BENCH_MODE: time the hot paths once at boot, then start the station normally
+ *  Runs against the real sensor, panel and (with ENABLE_FIREBASE) database. Compute-only
+ *  paths are also covered off-device by the host harness in host/.
+ *  setup() starts the uploader task only afterwards, so the upload benches own fbdo.
+ */
+#if BENCH_MODE
+void benchAll() {
+    Serial.printf("[BENCH] %lu iterations (%lu slow), I2C %lu Hz\n", (unsigned long)BENCH_ITERATIONS,
+                  (unsigned long)BENCH_SLOW_ITERATIONS, (unsigned long)I2C_CLOCK_HZ);
+
+    // Sensor
+    benchPrint(Serial, benchRun("readBME", BENCH_ITERATIONS, 1, [] { readBME(); }));
+  #if BME_BURST_READ
+    Sample s;
+    benchPrint(Serial, benchRun("burstSample", BENCH_ITERATIONS, 1, [&] { burstSample(s); }));
+    BME280Raw raw = { 519888, 415148, 30000 };          // datasheet example ADC values
+    int16_t t;
+    uint16_t h;
+    uint32_t p;
+    float tf, hf, pf;
+    benchPrint(Serial, benchRun("compensate int", BENCH_ITERATIONS, 16, [&] {
+        raw.adcT ^= 1;
+        bme280CompensateInt(bmeBurst.calibration(), raw, t, h, p);
+        benchSink += p;
+    }));
+    benchPrint(Serial, benchRun("compensate float", BENCH_ITERATIONS, 16, [&] {
+        raw.adcT ^= 1;
+        bme280Compensate(bmeBurst.calibration(), raw, tf, hf, pf);
+        benchSink += (uint32_t)pf;
+    }));
+  #endif
+    decltype(sampleFilter) filter(FILTER_DECIMATE);     // same stages, without disturbing the live state
+    Sample filtered;
+    benchPrint(Serial, benchRun("sampleFilter", BENCH_ITERATIONS, 16, [&] {
+        reading.pressure += 7;
+        filter.push(reading, filtered);
+        benchSink += filtered.pressure;
+    }));
+    readBME();
+    latest = reading;
+
+    if (oledReady) {
+        // Display, one benchmark per printBME() branch (skipped without a panel)
+        // Each iteration starts once the previous frame has been sent, so every one hands off a frame
+  #if OLED_ASYNC
+        Serial.println(F("[BENCH] printBME: loop() share only, drawing and the hand-off to the OLED task"));
+  #endif
+        bool fahren = false;
+        printBME(fahren);
+        benchPrint(Serial, benchRun("printBME same", BENCH_ITERATIONS, 1, [&] { printBME(fahren); }, oledWait));
+        benchPrint(Serial, benchRun("printBME toggle", BENCH_ITERATIONS, 1, [&] {
+            fahren = !fahren;
+            printBME(fahren);
+        }, oledWait));
+        benchPrint(Serial, benchRun("printBME full", BENCH_SLOW_ITERATIONS, 1, [&] {
+            oledLayout = false;
+            printBME(fahren);
+        }, oledWait));
+        Sample good = latest;
+        latest = makeSample(good.time, NAN, NAN, NAN);
+        benchPrint(Serial, benchRun("printBME error", BENCH_SLOW_ITERATIONS, 1, [&] { printBME(fahren); }, oledWait));
+        latest = good;
+        benchPrint(Serial, benchRun("display()", BENCH_SLOW_ITERATIONS, 1, [] { oledDisplay(); }, oledWait));
+        oledLayout = false;
+    }
+
+    // Payload construction
+    benchPrint(Serial, benchRun("liveJson", BENCH_ITERATIONS, 1, [] {
+        FirebaseJson json;
+        addLiveJson(json, latest);
+        benchSink += json.serializedBufferLength();
+    }));
+    benchPrint(Serial, benchRun("deriveMetrics", BENCH_ITERATIONS, 16, [] {
+        DerivedMetrics d = deriveMetrics(latest);
+        benchSink += (uint32_t)(d.dewPointC + d.absHumidity + d.heatIndexC);
+    }));
+    benchPrint(Serial, benchRun("logJson", BENCH_ITERATIONS, 16, [] {
+        static char buf[160];
+        JsonArena json(buf, sizeof(buf));
+        sampleLogJson(json, latest);
+        benchSink += json.size();
+    }));
+    benchPrint(Serial, benchRun("historyJson", BENCH_SLOW_ITERATIONS, 1, [] {
+        FirebaseJson json;
+        for (uint32_t i = 0; i < FB_HISTORY_CHUNK; i++) {
+            Sample r = latest;
+            r.time += i;
+            addHistoryJson(json, r, "");
+        }
+        benchSink += json.serializedBufferLength();
+    }));
+
+#if ENABLE_FIREBASE
+    // Upload, once the database is reachable
+    uint32_t start = millis();
+    while (!Firebase.ready() && millis() - start < BENCH_NET_TIMEOUT) {
+        wifi.poll();
+        delay(10);
+    }
+    if (Firebase.ready()) {
+        benchPrint(Serial, benchRun("updateFB", BENCH_UPLOADS, 1, [] { updateFB(latest); }));
+  #if FB_LOG_PUSH
+        benchPrint(Serial, benchRun("pushLog", BENCH_UPLOADS, 1, [] { pushLog(latest); }));
+  #endif
+    } else {
+        Serial.println(F("[BENCH] updateFB skipped: database not ready"));
     }
+#endif
 }
+#endif
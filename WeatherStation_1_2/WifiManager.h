@@ -0,0 +1,140 @@
+/**
+ *  @file WifiManager.h
+ *  @brief Non-blocking WiFi connection manager with cached join hints
+ *
+ *  The last good channel, BSSID and IP lease are kept in NVS. A join first tries
+ *  those hints (no scan, no DHCP); if that fails the hints are dropped and the next
+ *  attempt does a normal scan + DHCP. Failed attempts back off exponentially.
+ *  poll() never blocks -- call it periodically from the scheduler.
+ */
+#pragma once
+#include <WiFi.h>
+#include <Preferences.h>
+#include "Log.h"
+
+#define WIFI_NVS_NAMESPACE "wifi"
+#define WIFI_BACKOFF_MIN 1000           // First retry delay [ms]
+
+class WifiManager {
+public:
+    enum State { IDLE, CONNECTING, CONNECTED, BACKOFF };
+
+    /** Load the cached hints; the first poll() starts connecting */
+    void begin(const char *ssid, const char *pass, uint32_t timeoutMs, uint32_t backoffMaxMs) {
+        this->ssid = ssid;
+        this->pass = pass;
+        this->timeout = timeoutMs;
+        this->backoffMax = backoffMaxMs;
+
+        Preferences prefs;
+        if (prefs.begin(WIFI_NVS_NAMESPACE, true)) {
+            hintValid = prefs.getBytes("hint", &hint, sizeof(hint)) == sizeof(hint) && hint.channel != 0;
+            prefs.end();
+        }
+        WiFi.persistent(false);         // credentials come from config.h, not the SDK's flash copy
+        WiFi.setAutoReconnect(false);   // reconnects are driven by poll()
+        WiFi.mode(WIFI_STA);
+        state = IDLE;
+    }
+
+    void poll() {
+        uint32_t now = millis();
+        switch (state) {
+        case IDLE:
+            connect(now);
+            break;
+
+        case CONNECTING:
+            if (WiFi.status() == WL_CONNECTED) {
+                state = CONNECTED;
+                backoff = 0;
+                lastJoinMs = now - since;
+                saveHint();
+                LOG_INFO("WiFi connected in %lu ms (%s) with IP: %s", (unsigned long)lastJoinMs,
+                         usingHint ? "cached" : "scan", WiFi.localIP().toString().c_str());
+            } else if (now - since >= timeout) {
+                WiFi.disconnect();
+                if (usingHint) {
+                    hintValid = false;  // stale hint: scan and use DHCP next time
+                }
+                backoff = backoff ? (backoff * 2 > backoffMax ? backoffMax : backoff * 2) : WIFI_BACKOFF_MIN;
+                since = now;
+                state = BACKOFF;
+                LOG_INFO("WiFi join failed, retry in %lu ms", (unsigned long)backoff);
+            }
+            break;
+
+        case CONNECTED:
+            if (WiFi.status() != WL_CONNECTED) {
+                drops++;
+                LOG_INFO("WiFi link lost");
+                connect(now);
+            }
+            break;
+
+        case BACKOFF:
+            if (now - since >= backoff) {
+                connect(now);
+            }
+            break;
+        }
+    }
+
+    bool connected() const { return state == CONNECTED; }
+    State status() const { return state; }
+
+    uint32_t attempts = 0;              // Join attempts since boot
+    uint32_t drops = 0;                 // Established links that went down
+    uint32_t lastJoinMs = 0;            // Duration of the last successful join [ms]
+
+private:
+    struct __attribute__((packed)) Hint {
+        uint8_t channel;
+        uint8_t bssid[6];
+        uint32_t ip, gateway, subnet, dns;
+    };
+
+    void connect(uint32_t now) {
+        usingHint = hintValid;
+        if (usingHint) {
+            WiFi.config(IPAddress(hint.ip), IPAddress(hint.gateway), IPAddress(hint.subnet), IPAddress(hint.dns));
+            WiFi.begin(ssid, pass, hint.channel, hint.bssid, true);
+        } else {
+            WiFi.config(IPAddress((uint32_t)0), IPAddress((uint32_t)0), IPAddress((uint32_t)0));  // DHCP
+            WiFi.begin(ssid, pass);
+        }
+        attempts++;
+        since = now;
+        state = CONNECTING;
+    }
+
+    void saveHint() {
+        Hint h = {};
+        h.channel = (uint8_t)WiFi.channel();
+        memcpy(h.bssid, WiFi.BSSID(), sizeof(h.bssid));
+        h.ip = WiFi.localIP();
+        h.gateway = WiFi.gatewayIP();
+        h.subnet = WiFi.subnetMask();
+        h.dns = WiFi.dnsIP();
+        if (hintValid && memcmp(&h, &hint, sizeof(h)) == 0) {
+            return;                     // unchanged: spare the flash
+        }
+        hint = h;
+        hintValid = true;
+        Preferences prefs;
+        if (prefs.begin(WIFI_NVS_NAMESPACE, false)) {
+            prefs.putBytes("hint", &hint, sizeof(hint));
+            prefs.end();
+        }
+    }
+
+    const char *ssid = nullptr;
+    const char *pass = nullptr;
+    uint32_t timeout = 0, backoffMax = 0;
+    State state = IDLE;
+    uint32_t since = 0;                 // start of the current attempt / backoff [ms]
+    uint32_t backoff = 0;               // current backoff [ms]
+    Hint hint = {};
+    bool hintValid = false;
+    bool usingHint = false;
+};
@@ -1,7 +1,137 @@
+#pragma once
+#include <stdint.h>
+
 // Sensitive Information
 #define WIFI_SSID "wifi-ssid"
 #define WIFI_PASS "wifi-password"
 #define FIREBASE_HOST "default-rtdb.firebaseio.com"
 #define API_KEY "your-api-key"
 #define AUTH_MAIL "authorization-email"
-#define AUTH_PASS "authorization-password"
\ No newline at end of file
+#define AUTH_PASS "authorization-password"
+
+// Station Profile (typed constants: the compiler folds them and drops the unused paths)
+#define PROFILE_DESK 0              // always-on: 41 ms sampling, OLED every 2 s, upload every 10 min
+#define PROFILE_BATTERY 1           // deep sleep: one sample per minute, uploads in batches, OLED off
+#define PROFILE_HIGH_RATE 2         // always-on: 20 ms sampling, OLED every 0.5 s, report by exception
+#define STATION_PROFILE PROFILE_DESK
+
+struct StationProfile {
+    uint32_t sampleMs;              // BME280 read interval; deep-sleep period on battery [ms]
+    uint32_t displayMs;             // OLED refresh [ms]
+    uint32_t uploadMs;              // Firebase interval; the heartbeat with deadband, the batch period on battery [ms]
+    bool deadband;                  // Upload when a channel moves past its deadband (see Upload Policy)
+    uint8_t osrsT, osrsP, osrsH;    // BME280 oversampling: 1, 2, 4, 8 or 16 (~2.3 ms per step; forced mode must fit in sampleMs)
+    int16_t screenWidth, screenHeight;
+    float seaLevelHPa;              // Altitude reference [hPa]
+};
+constexpr StationProfile deskProfile     = { 41, 2000, 600000, false, 2, 8, 1, 128, 64, 1013.25f };   // 27.7 ms max conversion
+constexpr StationProfile batteryProfile  = { 60000, 0, 600000, false, 1, 1, 1, 128, 64, 1013.25f };
+constexpr StationProfile highRateProfile = { 20, 500, 60000, true, 1, 4, 1, 128, 64, 1013.25f };
+constexpr StationProfile station = STATION_PROFILE == PROFILE_BATTERY ? batteryProfile :
+                                   STATION_PROFILE == PROFILE_HIGH_RATE ? highRateProfile : deskProfile;
+
+// Firebase Upload
+#define ENABLE_FIREBASE 0           // 1: connect WiFi + Firebase and start the uploader task
+#define FB_BATCH_UPLOAD 1           // 1: single multi-path update per upload, 0: one write per node
+#define FB_ROOT "/BME280"           // Station node; give each station its own, e.g. "/stations/desk"
+#define FB_LOG_PUSH 0               // 1: also push each uploaded reading to FB_ROOT/log with a server timestamp (own TLS session)
+#define FB_LOG_TIMEOUT 5000         // Log push response timeout [ms]
+#define FB_LOG_BACKLOG 128          // Log records kept for a retry / catch-up push (12 bytes each)
+#define FB_QUEUE_DEPTH 8            // Readings buffered between loop() and the uploader task
+#define FB_TASK_STACK 8192          // Uploader task stack [bytes]
+#define FB_HISTORY_CAPACITY 512     // Readings kept in RAM while offline (12 bytes each)
+#define FB_HISTORY_CHUNK 32         // Buffered readings sent per catch-up request
+#define FB_FLASH_LOG 1              // 1: spill to a LittleFS log once the RAM history is full (needs a LittleFS/SPIFFS partition)
+#define FB_FLASH_CHUNK 64           // Flash-log readings sent per catch-up request
+#define FLASHLOG_SEGMENT_PAGES 16   // 252-byte pages per segment file (~4 KB, one erase block)
+#define FLASHLOG_MAX_SEGMENTS 256   // Segments kept before the oldest is dropped (~1 MB, ~86000 readings)
+#define FB_CACHE_TOKEN 1            // 1: keep the ID/refresh token in NVS and resume from it after a restart
+#define FB_KEEPALIVE_IDLE 30        // TCP keep-alive: idle time before the first probe [s]
+#define FB_KEEPALIVE_INTERVAL 10    // TCP keep-alive: probe interval [s]
+#define FB_KEEPALIVE_COUNT 3        // TCP keep-alive: failed probes before the session is dropped
+#define FB_PING_MS 0                // Idle request every N ms to keep the TLS session open (0: off)
+#define FB_REMOTE_CONFIG 1          // 1: follow FB_ROOT/config over an RTDB stream (a second TLS session, ~40 KB heap)
+#define FB_STREAM_RETRY_MS 30000    // Re-open a failed config stream after [ms]
+
+// Upload Policy (report by exception, with station.deadband)
+#define FB_DEADBAND_TEMP 20         // Temperature deadband [0.01 C]
+#define FB_DEADBAND_HUMID 100       // Humidity deadband [0.01 %RH]
+#define FB_DEADBAND_PRESS 50        // Pressure deadband [Pa]
+#define FB_MIN_INTERVAL 5000        // Rate limit between two uploads [ms]
+#define AGG_BASE_MS 60000           // Shortest statistics window; longer ones are 10x and 60x [ms]
+
+// BME280 Sensor
+#define BME_BURST_READ 1            // 1: read all channels in one I2C burst, 0: Adafruit readX() per channel
+#define BME_FORCED_MODE 1           // 1: trigger a forced conversion every bmeDelay (needs BME_BURST_READ), 0: normal mode
+#define BME_INT_COMPENSATION 1      // 1: datasheet integer compensation (no soft-float), 0: float formulas (needs BME_BURST_READ)
+#define BME_HW_FILTER 0             // BME280 IIR coefficient: 0 (off), 2, 4, 8 or 16 (lags by about N samples)
+
+// Software Filter (between readBME() and the sinks)
+#define FILTER_ENABLE 1             // 1: median + EMA per channel, 0: sinks see the raw readings
+#define FILTER_MEDIAN_TEMP 3        // Running median window, odd (1: off) -- spike rejection
+#define FILTER_MEDIAN_HUMID 3
+#define FILTER_MEDIAN_PRESS 3
+#define FILTER_EMA_TEMP 3           // EMA alpha = 1/2^N (0: off), time constant ~2^N samples
+#define FILTER_EMA_HUMID 3
+#define FILTER_EMA_PRESS 2
+#define FILTER_DECIMATE 1           // Pass every N-th filtered sample to the sinks
+
+// Sensor Registry (more BME280s, uploaded under FB_ROOT/devices/<id>)
+// X(id, address, mux channel 0-7 or SENSOR_NO_MUX), e.g. X("outdoor", 0x77, SENSOR_NO_MUX) X("attic", 0x77, 0)
+// Sensors behind the mux must not share an address with one on the main bus (0x76 is the primary sensor)
+#define SENSOR_LIST(X)
+#define SENSOR_POLL_MS 1000         // Read and re-trigger all registered sensors every N ms
+#define SENSOR_MUX_ADDR 0x70        // TCA9548A address
+
+// I2C Bus
+#define I2C_CLOCK_HZ 400000         // Shared bus clock: 100000, 400000 or 1000000 (SSD1306 is specified for 400 kHz; most modules tolerate 1 MHz)
+#define I2C_STATS_PERIOD 10000      // Print per-device bus usage every N ms (0: off)
+#define OLED_ASYNC 1                // 1: double-buffered OLED, frames sent by a background task between sensor reads, 0: sent from loop()
+#define OLED_TASK_STACK 2048        // OLED task stack [bytes]
+
+// Health
+#define HEALTH_WDT_S 60             // Task watchdog on loop() and the uploader: reboot after a stall of N s (0: off); keep it above the slowest RTDB request
+#define HEALTH_PERIOD 300000        // Publish heap, loop/upload latency, RSSI and failure counts to FB_ROOT/health every N ms (0: off, needs ENABLE_FIREBASE)
+
+// Logging
+#define LOG_LEVEL 3                 // 0: none, 1: errors, 2: + info, 3: + readings and statistics (see Log.h)
+#define HEAP_STATS_PERIOD 60000     // Print free heap, low-water mark and largest block every N ms (0: off)
+
+// Profiling
+#define PROFILE_ENABLE 0            // 1: time each loop() stage and print histograms (no cost when 0)
+#define PROFILE_PERIOD 30000        // Histogram dump interval [ms]
+#define BENCH_MODE 0                // 1: benchmark the hot paths once at boot (see Bench.h), then run normally
+#define BENCH_ITERATIONS 1000       // Iterations of the sensor, partial-display and JSON benchmarks
+#define BENCH_SLOW_ITERATIONS 50    // Iterations of the full-frame and history benchmarks
+#define BENCH_UPLOADS 20            // updateFB() round trips (needs ENABLE_FIREBASE)
+#define BENCH_NET_TIMEOUT 30000     // Wait for the database before skipping updateFB() [ms]
+
+// Scheduler
+#define SCHED_MAX_JOBS 12           // Periodic job table size
+#define SCHED_LIGHT_SLEEP 1         // 1: light-sleep between jobs when WiFi is off (never with USB CDC On Boot), 0: only yield
+
+// Low-Power Mode (battery)
+#define LOW_POWER_MODE (STATION_PROFILE == PROFILE_BATTERY)     // deep-sleep between samples and upload in batches
+#define LP_BATCH 32                 // Samples kept in RTC memory (12 bytes each)
+#define LP_WIFI_TIMEOUT 5000        // Give up joining WiFi after [ms]
+#define LP_FB_TIMEOUT 5000          // Give up waiting for Firebase after [ms]
+#define LP_NTP_TIMEOUT 3000         // Give up waiting for the first SNTP sync after [ms] (the batch is kept)
+#define LP_STATIC_IP ""             // Static IP for fast joins, "" for DHCP
+#define LP_GATEWAY ""
+#define LP_SUBNET "255.255.255.0"
+#define LP_DNS ""
+
+// WiFi Connection
+#define WIFI_POLL_MS 100            // Connection state machine poll interval [ms]
+#define WIFI_JOIN_TIMEOUT 10000     // Abandon a join attempt after [ms]
+#define WIFI_BACKOFF_MAX 60000      // Upper bound of the exponential retry delay [ms]
+#define NTP_SERVER "pool.ntp.org"   // SNTP servers, started on the first connection (UTC)
+#define NTP_SERVER2 "time.google.com"
+
+// Local HTTP Endpoint
+#define LOCAL_HTTP 0                // 1: serve /latest and /history as JSON on the LAN (brings WiFi up without Firebase)
+#define LOCAL_HTTP_PORT 80
+#define LOCAL_HTTP_POLL_MS 20       // Request poll interval (response latency) [ms]
+#define LOCAL_HTTP_CHUNK 512        // Response chunk buffer on the stack [bytes]
+#define LOCAL_HISTORY_MS 10000      // Local history interval [ms]
+#define LOCAL_HISTORY_CAPACITY 360  // Local history length (12 bytes each; 1 h at 10 s)
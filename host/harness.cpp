@@ -0,0 +1,719 @@
+/**
+ *  @file harness.cpp
+ *  @brief Host harness -- regression checks and micro-benchmarks of the sketch's compute paths
+ *
+ *  Builds the header-only modules of WeatherStation_1_2 against the mocks in mocks/.
+ *  The BME280 is emulated at the register level (Bosch datasheet trimming example),
+ *  so BME280Burst and the mocked Adafruit_BME280 run their real bus sequences.
+ *
+ *  Usage: harness [--bench]   (exit code = number of failed checks)
+ */
+#include <Arduino.h>
+#include <stdlib.h>
+#include <string.h>
+#include <Wire.h>
+#include <Adafruit_SSD1306.h>
+#include <Adafruit_BME280.h>
+#include "Aggregator.h"
+#include "BME280Burst.h"
+#include "Bench.h"
+#include "Derived.h"
+#include "Filters.h"
+#include "FlashLog.h"
+#include "Health.h"
+#include "I2CStats.h"
+#include "JsonArena.h"
+#include "OfflineBacklog.h"
+#include "OledDirty.h"
+#include "OledFont.h"
+#include "RemoteConfig.h"
+#include "RingBuffer.h"
+#include "Sample.h"
+#include "SampleJson.h"
+#include "SensorRegistry.h"
+#include "Sinks.h"
+#include "UploadPolicy.h"
+#include "WallClock.h"
+
+#define BENCH_N 2000
+
+// Bosch datasheet trimming example (section 8.1/8.2) plus plausible humidity trimming
+static const BME280Calib refCalib = {
+    27504, 26435, -1000,
+    36477, -10685, 3024, 2855, 140, -7, 15500, -14600, 6000,
+    75, 362, 0, 313, 50, 30
+};
+static const BME280Raw refRaw = { 519888, 415148, 30000 };
+
+static int failures = 0;
+
+static void check(bool ok, const char *what) {
+    printf("[CHECK] %-4s %s\n", ok ? "ok" : "FAIL", what);
+    if (!ok) failures++;
+}
+
+/** ==========[ FAKE BME280 ]========== **
+ *  Load trimming parameters and one set of ADC values into an emulated register file
+ */
+static void fakeBme280(I2CDevice &dev, uint8_t addr, const BME280Calib &c, const BME280Raw &r) {
+    memset(&dev, 0, sizeof(dev));
+    dev.addr = addr;
+    uint8_t *m = dev.regs;
+    const uint16_t tp[12] = {
+        c.T1, (uint16_t)c.T2, (uint16_t)c.T3, c.P1, (uint16_t)c.P2, (uint16_t)c.P3,
+        (uint16_t)c.P4, (uint16_t)c.P5, (uint16_t)c.P6, (uint16_t)c.P7, (uint16_t)c.P8, (uint16_t)c.P9
+    };
+    for (int i = 0; i < 12; i++) {
+        m[0x88 + 2 * i] = tp[i] & 0xFF;
+        m[0x89 + 2 * i] = tp[i] >> 8;
+    }
+    m[0xA1] = c.H1;
+    m[0xE1] = (uint16_t)c.H2 & 0xFF;
+    m[0xE2] = (uint16_t)c.H2 >> 8;
+    m[0xE3] = c.H3;
+    m[0xE4] = (uint8_t)(c.H4 >> 4);
+    m[0xE5] = (uint8_t)((c.H4 & 0x0F) | (c.H5 & 0x0F) << 4);
+    m[0xE6] = (uint8_t)(c.H5 >> 4);
+    m[0xE7] = (uint8_t)c.H6;
+    m[0xD0] = 0x60;                     // chip id
+    m[0xF4] = 0x25;                     // osrs_t x1, osrs_p x1, forced
+    m[0xF7] = r.adcP >> 12; m[0xF8] = r.adcP >> 4; m[0xF9] = (r.adcP & 0x0F) << 4;
+    m[0xFA] = r.adcT >> 12; m[0xFB] = r.adcT >> 4; m[0xFC] = (r.adcT & 0x0F) << 4;
+    m[0xFD] = r.adcH >> 8;  m[0xFE] = r.adcH & 0xFF;
+}
+
+static BME280Raw randomRaw() {
+    BME280Raw r;
+    r.adcT = 480000 + rand() % 80000;
+    r.adcP = 300000 + rand() % 200000;
+    r.adcH = 20000 + rand() % 30000;
+    return r;
+}
+
+/** ==========[ CHECKS ]========== **/
+static void checkCompensation() {
+    float t, h, p;
+    bme280Compensate(refCalib, refRaw, t, h, p);
+    check(fabsf(t - 25.08f) < 0.01f, "float compensation: datasheet temperature 25.08 C");
+    check(fabsf(p - 100653.27f) < 0.05f, "float compensation: datasheet pressure 100653.27 Pa");
+
+    int16_t ti;
+    uint16_t hi;
+    uint32_t pi;
+    bme280CompensateInt(refCalib, refRaw, ti, hi, pi);
+    check(ti == 2508, "int compensation: datasheet temperature 2508 [0.01 C]");
+    check(pi == 100653, "int compensation: datasheet pressure 100653 Pa");
+
+    float dt = 0, dh = 0, dp = 0;
+    srand(1);
+    for (int i = 0; i < 100000; i++) {
+        BME280Raw r = randomRaw();
+        bme280Compensate(refCalib, r, t, h, p);
+        bme280CompensateInt(refCalib, r, ti, hi, pi);
+        dt = fmaxf(dt, fabsf(t * 100 - ti));
+        dh = fmaxf(dh, fabsf(h * 100 - hi));
+        dp = fmaxf(dp, fabsf(p - pi));
+    }
+    printf("        int vs float: T %.2f cC, H %.2f c%%RH, P %.2f Pa\n", dt, dh, dp);
+    check(dt <= 1.0f && dh <= 2.0f && dp <= 1.5f, "int compensation agrees with float within rounding");
+    check(bme280MeasureMaxUs(2, 16, 1) == 46100 && bme280MeasureMaxUs(1, 0, 0) == 3550,
+          "datasheet max conversion time (T2/P16/H1 outlasts a 41 ms period)");
+}
+
+static void checkBus() {
+    static I2CDevice dev;
+    fakeBme280(dev, 0x76, refCalib, refRaw);
+    Wire.attach(dev);
+
+    I2CStats stats;
+    BME280Burst burst;
+    check(burst.begin(0x76, Wire, &stats), "BME280Burst::begin() on the emulated sensor");
+    check(memcmp(&burst.calibration(), &refCalib, sizeof(refCalib)) == 0, "trimming parameters parsed");
+    check(burst.oversampling() == 0x24, "oversampling bits kept, mode dropped");
+
+    I2CStats before = stats;
+    float t, h, p;
+    check(burst.read(t, h, p), "burst read");
+    I2CStats d = stats.since(before);
+    check(d.txns == 1 && d.bytes == 9, "burst read: one transaction, 1 + 8 bytes");
+
+    Sample s = makeSample(0, t, h, p);
+    int16_t ti;
+    uint16_t hi;
+    uint32_t pi;
+    check(burst.readInt(ti, hi, pi) && ti == s.temp && pi == s.pressure, "readInt() matches read()");
+
+    Adafruit_BME280 lib;
+    check(lib.begin(0x76, &Wire), "Adafruit_BME280 mock begin()");
+    uint32_t txns = Wire.transactions;
+    float lh = lib.readHumidity(), lt = lib.readTemperature(), lp = lib.readPressure();
+    check(Wire.transactions - txns == 5, "library path: five transactions per sample");
+    check(fabsf(lt - t) < 1e-3f && fabsf(lh - h) < 1e-3f && fabsf(lp - p) < 1e-1f, "library path matches burst");
+}
+
+static void checkRegistry() {
+    // 0x76 shadows the checkBus() sensor; the mock bus cannot isolate mux channels,
+    // so the mux only records the last channel mask written to it
+    static I2CDevice outdoor, attic, mux;
+    fakeBme280(outdoor, 0x77, refCalib, refRaw);
+    fakeBme280(attic, 0x76, refCalib, refRaw);
+    memset(&mux, 0, sizeof(mux));
+    mux.addr = 0x70;
+    Wire.attach(outdoor);
+    Wire.attach(attic);
+    Wire.attach(mux);
+
+    SensorRegistry<2> reg;
+    reg.add("outdoor", 0x77);
+    reg.add("attic", 0x76, 2);
+    check(reg.add("full", 0x76) < 0, "registry rejects entries beyond N");
+    check(reg.begin(Wire, nullptr, 0x70, 16) == 2, "begin() finds both emulated sensors");
+    check(outdoor.regs[0xE0] == 0xB6 && outdoor.regs[0xF2] == 0x01 && outdoor.regs[0xF5] == 0x10,
+          "reset and ctrl_hum / config written (IIR 16x)");
+    check(bme280FilterConfig(0) == 0x00 && bme280FilterConfig(2) == 0x04 && bme280FilterConfig(8) == 0x0C,
+          "IIR coefficient mapped onto the config register");
+    check(mux.ptr == 0, "mux closed after begin()");
+
+    check(!reg.poll(100), "first poll only triggers");
+    check(outdoor.regs[0xF4] == 0x55 && attic.regs[0xF4] == 0x55, "forced conversions started on all sensors");
+    attic.regs[0xF3] = 0x08;
+    check(!reg.poll(101) && !sampleValid(reg.entry(0).last), "poll waits while any sensor converts");
+    attic.regs[0xF3] = 0;
+    check(reg.poll(102), "poll reads once all are done");
+
+    BME280Burst burst;
+    burst.begin(0x77, Wire);
+    int16_t t;
+    uint16_t h;
+    uint32_t p;
+    burst.readInt(t, h, p);
+    const Sample &a = reg.entry(1).last;
+    check(a.time == 102 && a.temp == t && a.humid == h && a.pressure == p, "registry reading matches readInt()");
+    check(mux.ptr == 0, "mux closed after poll()");
+}
+
+static void checkSample() {
+    Sample s = makeSample(1700000000, 21.456f, 101.0f, 100653.4f);
+    check(sizeof(Sample) == 12, "Sample is 12 bytes");
+    check(s.temp == 2146 && s.humid == 10000 && s.pressure == 100653, "makeSample rounds and clamps");
+    check(!sampleValid(makeSample(0, NAN, 50.0f, 1e5f)), "NaN yields an invalid sample");
+    check(fabsf(sampleTempF(s) - 70.628f) < 1e-3f, "Fahrenheit derived on demand");
+
+    float worst = 0;
+    for (uint32_t pa = 52000; pa <= 110000; pa += 10) {
+        Sample q = makeSample(0, 20.0f, 50.0f, (float)pa);
+        float ref = 44330.0f * (1.0f - powf(pa / 101325.0f, 0.1903f));
+        worst = fmaxf(worst, fabsf(sampleAltitude(q, 1013.25f) - ref));
+    }
+    printf("        altitude table: worst error %.3f m\n", worst);
+    check(worst < 0.5f, "altitude table within 0.5 m of powf()");
+}
+
+static void checkSampleJson() {
+    char buf[128];
+    Sample s = makeSample(1700000000, 21.5f, 45.07f, 100653.0f);
+    sampleJson(buf, sizeof(buf), s);
+    check(strcmp(buf, "{\"time\":1700000000,\"temperature\":21.50,\"humidity\":45.07,\"pressure\":100653}") == 0,
+          "sampleJson renders the fixed-point channels");
+    s = makeSample(0, -0.05f, 0.0f, 0.0f);
+    sampleJson(buf, sizeof(buf), s);
+    check(strstr(buf, "\"temperature\":-0.05,") != nullptr, "sampleJson keeps the sign below 1 C");
+    s = makeSample(0xFFFFFFFF, -327.68f, 100.0f, 4294967295.0f);
+    check(sampleJson(buf, sizeof(buf), s) < 96, "worst-case record fits the 96-byte chunk reserve");
+}
+
+static void checkJsonArena() {
+    char buf[160];
+    JsonArena j(buf, sizeof(buf));
+    sampleLogJson(j, makeSample(1700000000, 21.5f, 45.07f, 100653.0f));
+    check(j.ok() && strcmp(buf, "{\"time\":1700000000,\"humidity\":45.07,\"temperature\":{\"C\":21.50,\"F\":70.70},"
+                                "\"Pressure\":1.00653,\"ts\":{\".sv\":\"timestamp\"}}") == 0, "arena: log record");
+
+    j.clear();
+    j.open().key("a").fixed(-5, 2).key("b").fixed(-1234, 1).key("c").real(-0.126f, 2).key("d").fixed(7, 0).close();
+    check(strcmp(buf, "{\"a\":-0.05,\"b\":-123.4,\"c\":-0.13,\"d\":7}") == 0, "arena: signs, rounding, no decimals");
+
+    char tiny[16];
+    JsonArena t(tiny, sizeof(tiny));
+    sampleLogJson(t, makeSample(0, -10.0f, 0.0f, 0.0f));
+    check(!t.ok() && t.size() < sizeof(tiny), "arena: overflow flagged, never overrun");
+}
+
+static void checkRingBuffer() {
+    RingBuffer<int, 4> rb;
+    for (int i = 0; i < 4; i++) rb.push(i);
+    check(!rb.push(4) && rb.overwritten == 1, "push() into a full buffer overwrites the oldest");
+    check(rb.peek(0) == 1 && rb.peek(3) == 4, "oldest-first order after overwrite");
+    rb.pop(3);
+    check(rb.size() == 1 && rb.peek(0) == 4, "pop() discards from the front");
+}
+
+static void checkUploadPolicy() {
+    UploadPolicy policy({ 20, 100, 50 }, 5000, 600000);
+    Sample s = makeSample(0, 20.0f, 50.0f, 100000.0f);
+    check(policy.due(s, 0) == UploadPolicy::FIRST, "policy: first sample is due");
+    policy.commit(s, 0);
+    Sample big = makeSample(0, 20.5f, 50.0f, 100000.0f);
+    check(policy.due(big, 1000) == UploadPolicy::NONE, "policy: rate limited inside minMs");
+    check(policy.due(big, 6000) == UploadPolicy::DELTA, "policy: deadband exceeded");
+    check(policy.due(s, 6000) == UploadPolicy::NONE, "policy: inside the deadband");
+    check(policy.due(s, 600000) == UploadPolicy::HEARTBEAT, "policy: heartbeat after maxMs");
+}
+
+typedef SampleFilter<ChannelFilter<3, 3>, ChannelFilter<3, 3>, ChannelFilter<3, 2>> StationFilter;
+
+static void checkDerived() {
+    float worstLn = 0, worstExp = 0;
+    for (float x = 0.001f; x < 1000.0f; x *= 1.01f) {
+        worstLn = fmaxf(worstLn, fabsf(fastLn(x) - logf(x)));
+    }
+    for (float x = -20.0f; x < 20.0f; x += 0.01f) {
+        worstExp = fmaxf(worstExp, fabsf(fastExp(x) / expf(x) - 1.0f));
+    }
+    check(worstLn < 2e-4f && worstExp < 2e-5f, "derived: fast ln / exp within 2e-4 abs / 2e-5 rel");
+
+    // Reference: the same Magnus formulas through libm
+    float worstDew = 0, worstAbs = 0;
+    for (int t = -2000; t <= 4500; t += 250) {
+        for (int rh = 500; rh <= 10000; rh += 500) {
+            Sample s = makeSample(0, t * 0.01f, rh * 0.01f, 101325.0f);
+            DerivedMetrics d = deriveMetrics(s);
+            float m = DERIVED_MAGNUS_B * s.temp * 0.01f / (DERIVED_MAGNUS_C + s.temp * 0.01f);
+            float g = logf(rh * 0.0001f) + m;
+            worstDew = fmaxf(worstDew, fabsf(d.dewPointC - DERIVED_MAGNUS_C * g / (DERIVED_MAGNUS_B - g)));
+            float ah = 216.7f * DERIVED_MAGNUS_E0 * expf(m) * rh * 0.0001f / (273.15f + s.temp * 0.01f);
+            worstAbs = fmaxf(worstAbs, fabsf(d.absHumidity - ah));
+        }
+    }
+    check(worstDew < 0.01f && worstAbs < 0.01f, "derived: dew point / absolute humidity match libm within 0.01");
+
+    DerivedMetrics d = deriveMetrics(makeSample(0, 20.0f, 50.0f, 101325.0f));
+    check(fabsf(d.dewPointC - 9.26f) < 0.02f && fabsf(d.absHumidity - 8.63f) < 0.02f,
+          "derived: 20 C / 50 % -> dew point 9.3 C, 8.6 g/m3");
+    d = deriveMetrics(makeSample(0, (90.0f - 32.0f) / 1.8f, 70.0f, 101325.0f));
+    check(fabsf(celsiusToF(d.heatIndexC) - 105.9f) < 0.2f, "derived: heat index 90 F / 70 % -> 106 F (NWS table)");
+    d = deriveMetrics(makeSample(0, 15.0f, 60.0f, 101325.0f));
+    check(fabsf(d.heatIndexC - 15.0f) < 1.0f, "derived: heat index tracks the air temperature when cool");
+
+    PressureTrend<18> trend;
+    for (int i = 0; i < 18; i++) trend.push(1013.0f - i * 0.15f);
+    check(!trend.ready() && trend.tendency() == TREND_UNKNOWN, "derived: tendency unknown before 3 h");
+    trend.push(1013.0f - 18 * 0.15f);
+    check(trend.ready() && fabsf(trend.change() + 2.7f) < 1e-3f && trend.tendency() == TREND_FALLING,
+          "derived: -2.7 hPa over 18 windows is falling");
+    for (int i = 0; i < 18; i++) trend.push(1010.0f + i * 0.3f);
+    // oldest kept: the last falling window (1010.3), newest 1010 + 17 * 0.3
+    check(fabsf(trend.change() - 4.8f) < 1e-3f && trend.tendency() == TREND_RISING_FAST,
+          "derived: ring keeps only the last 3 h");
+    check(classifyTendency(1.5f) == TREND_STEADY && classifyTendency(-1.6f) == TREND_FALLING &&
+          !strcmp(tendencyName(TREND_RISING_FAST), "rising fast"), "derived: tendency classes");
+}
+
+static void checkFilters() {
+    RunningMedian<3> med;
+    med.push(100);
+    med.push(101);
+    check(med.push(5000) == 101 && med.push(102) == 102, "median: single spike rejected");
+
+    Ema<3> ema;
+    ema.push(0);
+    int32_t y = 0;
+    uint8_t n = 0;
+    while (y < 632) {                   // 63.2 % of a 1000 step
+        y = ema.push(1000);
+        n++;
+    }
+    check(n == 8, "EMA 1/8: time constant of 8 samples");
+    for (int i = 0; i < 200; i++) y = ema.push(1000);
+    check(y == 1000, "EMA settles on the input (no truncation bias)");
+    Ema<0> pass;
+    check(pass.push(-123) == -123, "EMA shift 0 passes through");
+
+    StationFilter f(4);
+    Sample in = makeSample(10, 21.0f, 45.0f, 100000.0f), out = makeSample(0, NAN, NAN, NAN);
+    uint8_t emitted = 0;
+    for (int i = 0; i < 40; i++) {
+        in.time = 10 + i;
+        in.temp = 2100 + (i % 2 ? 20 : -20);            // +-0.2 C jitter
+        in.pressure = i == 17 ? 120000 : 100000;        // one spike
+        emitted += f.push(in, out);
+    }
+    check(emitted == 10 && out.time == 49, "decimation: every 4th sample, latest timestamp");
+    check(abs(out.temp - 2100) <= 5 && out.pressure == 100000, "jitter smoothed, spike rejected");
+    check(f.push(makeSample(50, NAN, NAN, NAN), out) && !sampleValid(out), "invalid sample passes at once");
+    check(!f.push(in, out), "filter restarts after an invalid sample");
+}
+
+static void checkRemoteConfig() {
+    RemoteConfig rc;
+    check(rc.empty() && rc.set("uploadMs", 60000) && rc.uploadMs == 60000, "remote config: key set");
+    check(!rc.set("uploadMs", 10) && rc.uploadMs == 60000, "remote config: out-of-range value rejected");
+    check(!rc.set("fbDelay", 5000) && !rc.setUnit("K") && rc.unit == RC_UNSET, "remote config: unknown key / unit ignored");
+
+    RemoteConfig live, update;
+    live.set("sampleMs", 41);
+    live.set("uploadMs", 600000);
+    update.set("uploadMs", 30000);
+    update.setUnit("F");
+    live.merge(update);
+    check(live.sampleMs == 41 && live.uploadMs == 30000 && live.unit == UNIT_F && live.displayMs == RC_UNSET,
+          "remote config: merge keeps fields the update does not set");
+}
+
+static void checkFlashLog() {
+    fs::FS flash;
+    FlashLog log(2, 4);                 // 42-record segments, at most 4 of them
+    check(log.begin(flash) && log.size() == 0, "flash log: empty on a fresh file system");
+
+    for (uint32_t t = 0; t < 20; t++) log.append(makeSample(t, 20.0f, 50.0f, 1e5f));
+    Sample buf[32];
+    check(log.size() == 20 && flash.writes == 0 && log.peek(buf, 32) == 20 && buf[19].time == 19,
+          "flash log: partial page served from RAM, nothing written");
+    log.consume(20);
+
+    for (uint32_t t = 100; t < 100 + 21 * 10; t++) log.append(makeSample(t, 20.0f, 50.0f, 1e5f));
+    check(flash.writes == 10 + 4 && flash.bytesWritten == 10 * 252 + 4 * 16,
+          "flash log: whole 252-byte pages, index only on rotation");
+    // 10 pages into 2-page segments, 4 kept: the oldest segment (42 records) dropped
+    check(log.size() == 168 && log.dropped == 42, "flash log: oldest segment dropped when full");
+
+    FlashLog reopened(2, 4);
+    reopened.begin(flash);
+    check(reopened.size() == 168, "flash log: cursor and records survive a restart");
+
+    uint32_t next = 142, bad = 0, n;
+    while ((n = reopened.peek(buf, 32)) > 0) {
+        for (uint32_t i = 0; i < n; i++) bad += buf[i].time != next++;
+        reopened.consume(n);
+    }
+    check(bad == 0 && next == 310 && reopened.size() == 0, "flash log: drained oldest first, in order");
+    check(flash.fileCount() == 1, "flash log: acknowledged segments deleted (index left)");
+}
+
+static void checkOfflineBacklog() {
+    fs::FS flash;
+    FlashLog log(2, 4);
+    log.begin(flash);
+    OfflineBacklog<16> backlog;
+    backlog.attach(&log);
+
+    // 16 into the ring, the next 100 into flash; after a partial drain the ring has room
+    // again, but new readings must queue behind the flash ones
+    uint32_t stored = 0, next = 0, seen = 0, bad = 0;
+    bool kept = true;
+    for (; stored < 16 + 100; stored++) kept &= backlog.store(makeSample(stored, 20.0f, 50.0f, 1e5f));
+    check(kept && backlog.size() == 116 && log.size() == 100, "offline backlog: ring full, overflow in flash");
+
+    Sample buf[8];
+    for (int round = 0; round < 3; round++) {
+        size_t n = backlog.peek(buf, 8);
+        for (size_t i = 0; i < n; i++) bad += buf[i].time != next++;
+        backlog.consume(n);
+        seen += n;
+    }
+    for (uint32_t end = stored + 30; stored < end; stored++) kept &= backlog.store(makeSample(stored, 20.0f, 50.0f, 1e5f));
+    check(kept && !backlog.inRam() && log.size() == 100 - 8 + 30, "offline backlog: readings stay behind the flash log");
+
+    size_t n;
+    while ((n = backlog.peek(buf, 8)) > 0) {
+        for (size_t i = 0; i < n; i++) bad += buf[i].time != next++;
+        backlog.consume(n);
+        seen += n;
+    }
+    check(bad == 0 && seen == stored && next == stored && backlog.empty() && log.dropped == 0,
+          "offline backlog: every reading back exactly once, oldest first");
+
+    OfflineBacklog<4> ramOnly;
+    for (uint32_t t = 0; t < 6; t++) ramOnly.store(makeSample(t, 20.0f, 50.0f, 1e5f));
+    check(ramOnly.size() == 4 && ramOnly.peek(buf, 8) == 4 && buf[0].time == 2,
+          "offline backlog: without flash the ring overwrites its oldest");
+}
+
+static void checkWallClock() {
+    WallClock clock(1600000000UL);
+    uint32_t early = clock.stamp(40, 40000);           // 40 s after boot, unsynced
+    clock.stamp(95, 95000);
+    check(!clock.synced() && !clock.timed(early) && clock.rebase(early) == early,
+          "wall clock: boot-relative stamps stay untimed before the sync");
+    clock.stamp(1700000000UL, 97000);                   // synced 2 s after the last unsynced stamp
+    check(clock.synced() && clock.rebase(early) == 1700000000UL - 57 && clock.rebase(1700000005UL) == 1700000005UL,
+          "wall clock: early stamps rebased onto the epoch");
+
+    WallClock warm(1600000000UL);                       // clock already valid (kept across deep sleep)
+    warm.stamp(1700000000UL, 100);
+    check(warm.synced() && !warm.timed(warm.rebase(40)), "wall clock: unknown offset leaves old stamps untimed");
+}
+
+static void checkHealth() {
+    UploadHealth up;
+    check(up.successPct() == 100 && up.ms.mean() == 0, "health: no attempts reads as healthy");
+    up.add(true, 120);
+    up.add(true, 80);
+    up.add(false, 5000);
+    up.add(true, 100);
+    check(up.ok == 3 && up.failed == 1 && up.successPct() == 75, "health: upload success rate");
+    check(up.ms.last == 100 && up.ms.max == 5000 && up.ms.mean() == 1325, "health: upload latency last/max/mean");
+    up.reset();
+    up.add(true, 90);
+    check(up.ok == 4 && up.failed == 1 && up.successPct() == 100 && up.ms.max == 90,
+          "health: window restarts, totals since boot kept");
+
+    check(heapFragmentation(100000, 100000) == 0 && heapFragmentation(0, 0) == 0, "health: contiguous heap 0 %");
+    check(heapFragmentation(120000, 30000) == 75 && heapFragmentation(4000000000u, 1000000000u) == 75,
+          "health: fragmentation from free / largest block");
+}
+
+static void checkAggregator() {
+    const uint16_t mult[3] = { 1, 10, 60 };
+    Aggregator<3> agg(60000, mult);
+    uint32_t closes[3] = {};
+    for (uint32_t t = 0; t <= 3600; t++) {
+        Sample s = makeSample(t, 20.0f + (t % 100) * 0.01f, 50.0f, 100000.0f);
+        uint8_t closed = agg.add(s, t * 1000);
+        for (uint8_t l = 0; l < 3; l++) {
+            if (closed & (1 << l)) closes[l]++;
+        }
+    }
+    check(closes[0] == 60 && closes[1] == 6 && closes[2] == 1, "aggregator: 60 / 6 / 1 windows per hour");
+    const Welford &h = agg.last(2).ch[AGG_TEMP];
+    // The first window also holds the t = 0 sample: 3601 samples, (3600 * 0.495 + 0) / 3601 above 20 C
+    check(h.n == 3601 && fabsf(h.mean - 20.49486f) < 1e-4f, "aggregator: hourly mean");
+    check(fabsf(h.lo - 20.0f) < 1e-4f && fabsf(h.hi - 20.99f) < 1e-4f, "aggregator: hourly min/max");
+    check(fabsf(h.stddev() - 0.2887f) < 1e-3f, "aggregator: hourly stddev");
+}
+
+struct CountingSink {
+    SinkRate rate;
+    uint32_t published = 0;
+    explicit CountingSink(uint32_t periodMs) : rate(periodMs) {}
+    bool due(const Sample &s, uint32_t now) { return sampleValid(s) && rate.due(now); }
+    void publish(const Sample &, uint32_t now) {
+        rate.accept(now);
+        published++;
+    }
+};
+
+static void checkSinks() {
+    CountingSink every(0), fast(2000), slow(600000);
+    SinkFanOut<CountingSink, CountingSink, CountingSink> fan(every, fast, slow);
+    Sample s = makeSample(0, 20.0f, 50.0f, 100000.0f);
+    for (uint32_t now = 0; now < 3600000; now += 41) fan.offer(s, now);
+    fan.offer(makeSample(0, NAN, NAN, NAN), 3600000);
+    printf("        sinks: %lu / %lu / %lu\n", (unsigned long)every.published, (unsigned long)fast.published,
+           (unsigned long)slow.published);
+    check(every.published == 87805, "fan-out: period 0 sees every valid sample");
+    check(fast.published == 1800 && slow.published == 6, "fan-out: each sink keeps its own rate");
+}
+
+static void checkOledDirty() {
+    Adafruit_SSD1306 display(128, 64, &Wire);
+    OledDirty<128, 64> dirty;
+    check(!dirty.dirty() && dirty.flush(display, Wire, 0x3C) == 0, "clean panel sends nothing");
+
+    dirty.mark(42, 0, 60, 16);
+    uint32_t cmds = display.commands;
+    check(dirty.flush(display, Wire, 0x3C) == 120, "one size-2 field: 2 pages x 60 columns");
+    check(display.commands - cmds == 6, "two pages with the same span share one window");
+
+    dirty.mark(0, 0, 128, 64);
+    check(dirty.flush(display, Wire, 0x3C) == 1024, "full mark sends the whole framebuffer");
+
+    struct CountingLock {
+        uint32_t locks = 0;
+        int depth = 0, maxDepth = 0;
+        void lock() { locks++; if (++depth > maxDepth) maxDepth = depth; }
+        void unlock() { depth--; }
+    } bus;
+    static uint8_t front[128 * 64 / 8];
+    memset(front, 0x5A, sizeof(front));
+    dirty.mark(0, 0, 128, 64);
+    uint32_t out = Wire.bytesOut;
+    cmds = display.commands;
+    check(dirty.flush(front, display, Wire, 0x3C, bus) == 1024 && !dirty.dirty(), "front buffer sent in full");
+    // one address window, then 1024 bytes in 31-byte chunks (34 writes, each with a control byte)
+    check(bus.locks == 1 + 34 && bus.maxDepth == 1 && bus.depth == 0, "bus held per window and per chunk");
+    check(display.commands - cmds == 6 && Wire.bytesOut - out == 1024 + 34, "same bus traffic as the unlocked flush");
+}
+
+static void checkOledFont() {
+    static uint8_t buf[128 * 64 / 8];
+    memset(buf, 0xAA, sizeof(buf));
+    check(!oledBlit2x(buf, 128, 42, 3, "1.0%", 5) && buf[3 * 128 + 42] == 0xAA, "unsupported glyph: nothing drawn");
+    check(oledBlit2x(buf, 128, 42, 3, "1", 5), "blit one digit");
+    const uint8_t *top = buf + 3 * 128 + 42, *bottom = top + 128;
+    // '1' column 1 is 0x42: rows 1 and 6 -> doubled to rows 2,3 (0x0C) and 12,13 (0x30)
+    check(top[2] == 0x0C && top[3] == 0x0C && bottom[2] == 0x30 && bottom[3] == 0x30, "columns doubled into two pages");
+    check(top[59] == 0 && top[60] == 0xAA && top[-1] == 0xAA && bottom[60] == 0xAA, "only the field is cleared");
+    check(oledBlit2x(buf, 128, 108, 3, "CF", 5) && buf[3 * 128 + 127] == 0, "clipped at the panel edge");
+}
+
+/** ==========[ BENCHMARKS ]========== **/
+static void runBenchmarks() {
+    BME280Raw raw = refRaw;
+    float t, h, p;
+    int16_t ti;
+    uint16_t hi;
+    uint32_t pi;
+    benchPrint(Serial, benchRun("compensate float", BENCH_N, 256, [&] {
+        raw.adcT ^= 1;
+        bme280Compensate(refCalib, raw, t, h, p);
+        benchSink += (uint32_t)p;
+    }));
+    benchPrint(Serial, benchRun("compensate int", BENCH_N, 256, [&] {
+        raw.adcT ^= 1;
+        bme280CompensateInt(refCalib, raw, ti, hi, pi);
+        benchSink += pi;
+    }));
+
+    Sample s = makeSample(1700000000, 21.5f, 45.0f, 100653.0f);
+    benchPrint(Serial, benchRun("makeSample", BENCH_N, 256, [&] {
+        s = makeSample(s.time + 1, 21.5f, 45.0f, (float)(s.time & 0xFFFF) + 90000.0f);
+        benchSink += s.pressure;
+    }));
+    benchPrint(Serial, benchRun("altitude table", BENCH_N, 256, [&] {
+        s.pressure ^= 1;
+        benchSink += (uint32_t)sampleAltitude(s, 1013.25f);
+    }));
+    benchPrint(Serial, benchRun("altitude powf", BENCH_N, 256, [&] {
+        s.pressure ^= 1;
+        benchSink += (uint32_t)(44330.0f * (1.0f - powf(sampleHPa(s) / 1013.25f, 0.1903f)));
+    }));
+
+    StationFilter filter(1);
+    Sample filtered;
+    benchPrint(Serial, benchRun("sample filter", BENCH_N, 256, [&] {
+        s.pressure += 7;
+        filter.push(s, filtered);
+        benchSink += filtered.pressure;
+    }));
+
+    char buf[48];
+    benchPrint(Serial, benchRun("format fields", BENCH_N, 64, [&] {
+        s.temp ^= 1;
+        snprintf(buf, sizeof(buf), "%.1f", sampleHumid(s));
+        snprintf(buf, sizeof(buf), "%.1f", sampleTempC(s));
+        snprintf(buf, sizeof(buf), "%.2f", sampleBar(s));
+        benchSink += buf[0];
+    }));
+    char json[96];
+    benchPrint(Serial, benchRun("sampleJson", BENCH_N, 64, [&] {
+        s.temp ^= 1;
+        benchSink += sampleJson(json, sizeof(json), s);
+    }));
+    char arena[160];
+    JsonArena rec(arena, sizeof(arena));
+    benchPrint(Serial, benchRun("arena record", BENCH_N, 64, [&] {
+        s.temp ^= 1;
+        rec.clear();
+        sampleLogJson(rec, s);
+        benchSink += rec.size();
+    }));
+    benchPrint(Serial, benchRun("printf record", BENCH_N, 64, [&] {
+        s.temp ^= 1;
+        benchSink += snprintf(arena, sizeof(arena), "{\"time\":%lu,\"humidity\":%.2f,\"temperature\":{\"C\":%.2f,"
+                              "\"F\":%.2f},\"Pressure\":%.5f,\"ts\":{\".sv\":\"timestamp\"}}",
+                              (unsigned long)s.time, sampleHumid(s), sampleTempC(s), sampleTempF(s), sampleBar(s));
+    }));
+    benchPrint(Serial, benchRun("derive fast", BENCH_N, 256, [&] {
+        s.temp ^= 1;
+        DerivedMetrics d = deriveMetrics(s);
+        benchSink += (uint32_t)(d.dewPointC * 100 + d.absHumidity);
+    }));
+    benchPrint(Serial, benchRun("derive libm", BENCH_N, 256, [&] {
+        s.temp ^= 1;
+        float t = sampleTempC(s), m = DERIVED_MAGNUS_B * t / (DERIVED_MAGNUS_C + t);
+        float g = logf(sampleHumid(s) * 0.01f) + m;
+        float dew = DERIVED_MAGNUS_C * g / (DERIVED_MAGNUS_B - g);
+        float ah = 216.7f * DERIVED_MAGNUS_E0 * expf(m) * sampleHumid(s) * 0.01f / (273.15f + t);
+        benchSink += (uint32_t)(dew * 100 + ah + heatIndexF(celsiusToF(t), sampleHumid(s)));
+    }));
+    benchPrint(Serial, benchRun("history keys x32", BENCH_N, 4, [&] {
+        for (uint32_t i = 0; i < 32; i++) {
+            snprintf(buf, sizeof(buf), "%s%lu/humidity", "history/", (unsigned long)(s.time + i));
+            snprintf(buf, sizeof(buf), "%s%lu/temperature/C", "history/", (unsigned long)(s.time + i));
+            snprintf(buf, sizeof(buf), "%s%lu/Pressure", "history/", (unsigned long)(s.time + i));
+            benchSink += buf[9];
+        }
+    }));
+
+    Adafruit_SSD1306 display(128, 64, &Wire);
+    OledDirty<128, 64> dirty;
+    benchPrint(Serial, benchRun("oled field flush", BENCH_N, 16, [&] {
+        dirty.mark(42, 24, 60, 16);
+        benchSink += dirty.flush(display, Wire, 0x3C);
+    }));
+    static uint8_t fb[128 * 64 / 8];
+    char field[8] = "21.5";
+    benchPrint(Serial, benchRun("oled blit field", BENCH_N, 64, [&] {
+        field[3] = '0' + (field[3] - '0' + 1) % 10;
+        oledBlit2x(fb, 128, 42, 3, field, 5);
+        benchSink += fb[3 * 128 + 50];
+    }));
+    benchPrint(Serial, benchRun("oled display()", BENCH_N, 4, [&] { display.display(); }));
+
+    BME280Burst burst;
+    burst.begin(0x76, Wire);
+    benchPrint(Serial, benchRun("burst readInt", BENCH_N, 64, [&] {
+        burst.readInt(ti, hi, pi);
+        benchSink += pi;
+    }));
+    Adafruit_BME280 lib;
+    lib.begin(0x76, &Wire);
+    benchPrint(Serial, benchRun("library 3 reads", BENCH_N, 64, [&] {
+        benchSink += (uint32_t)(lib.readHumidity() + lib.readTemperature() + lib.readPressure());
+    }));
+
+    const uint16_t mult[3] = { 1, 10, 60 };
+    Aggregator<3> agg(60000, mult);
+    uint32_t now = 0;
+    benchPrint(Serial, benchRun("aggregator add", BENCH_N, 256, [&] {
+        now += 41;
+        s.temp ^= 1;
+        benchSink += agg.add(s, now);
+    }));
+
+    RingBuffer<Sample, 512> history;
+    benchPrint(Serial, benchRun("history push/pop", BENCH_N, 256, [&] {
+        history.push(s);
+        if (history.full()) history.pop(32);
+        benchSink += history.size();
+    }));
+
+    UploadPolicy policy({ 20, 100, 50 }, 5000, 600000);
+    policy.commit(s, 0);
+    benchPrint(Serial, benchRun("policy due", BENCH_N, 256, [&] {
+        now += 1000;
+        s.temp ^= 1;
+        benchSink += policy.due(s, now);
+    }));
+}
+
+int main(int argc, char **argv) {
+    bool bench = argc > 1 && strcmp(argv[1], "--bench") == 0;
+
+    checkCompensation();
+    checkBus();
+    checkRegistry();
+    checkSample();
+    checkSampleJson();
+    checkJsonArena();
+    checkRingBuffer();
+    checkUploadPolicy();
+    checkDerived();
+    checkFilters();
+    checkRemoteConfig();
+    checkFlashLog();
+    checkOfflineBacklog();
+    checkWallClock();
+    checkHealth();
+    checkAggregator();
+    checkSinks();
+    checkOledDirty();
+    checkOledFont();
+    printf("[CHECK] %d failed\n", failures);
+
+    if (bench) {
+        runBenchmarks();
+    }
+    return failures;
+}
@@ -0,0 +1,72 @@
+/**
+ *  @file Adafruit_BME280.h
+ *  @brief Host mock -- per-channel reads with the library's bus pattern
+ *
+ *  Like the real library, every readX() is its own register transaction and pressure
+ *  and humidity re-read the temperature for t_fine. The math is the sketch's float
+ *  compensation, so results match BME280Burst while the bus traffic does not.
+ */
+#pragma once
+#include "Wire.h"
+#include "BME280Burst.h"
+
+class Adafruit_BME280 {
+public:
+    bool begin(uint8_t addr = 0x77, TwoWire *wire = &Wire) {
+        this->addr = addr;
+        this->wire = wire;
+        BME280Burst trim;
+        if (!trim.begin(addr, *wire)) return false;
+        calib = trim.calibration();
+        return true;
+    }
+
+    float readTemperature() {
+        BME280Raw r = {};
+        r.adcT = read20(0xFA);
+        return compensate(r).t;
+    }
+
+    float readPressure() {
+        BME280Raw r = {};
+        r.adcT = read20(0xFA);
+        r.adcP = read20(0xF7);
+        return compensate(r).p;
+    }
+
+    float readHumidity() {
+        BME280Raw r = {};
+        r.adcT = read20(0xFA);
+        uint8_t d[2];
+        readRegs(0xFD, d, 2);
+        r.adcH = (int32_t)d[0] << 8 | d[1];
+        return compensate(r).h;
+    }
+
+private:
+    struct Result { float t, h, p; };
+
+    Result compensate(const BME280Raw &r) {
+        Result x;
+        bme280Compensate(calib, r, x.t, x.h, x.p);
+        return x;
+    }
+
+    int32_t read20(uint8_t reg) {
+        uint8_t d[3];
+        readRegs(reg, d, 3);
+        return (int32_t)d[0] << 12 | (int32_t)d[1] << 4 | d[2] >> 4;
+    }
+
+    void readRegs(uint8_t reg, uint8_t *buf, uint8_t len) {
+        wire->beginTransmission(addr);
+        wire->write(reg);
+        wire->endTransmission(false);
+        wire->requestFrom(addr, len);
+        for (uint8_t i = 0; i < len; i++) buf[i] = (uint8_t)wire->read();
+    }
+
+    uint8_t addr = 0x77;
+    TwoWire *wire = &Wire;
+    BME280Calib calib = {};
+};
@@ -0,0 +1,56 @@
+/**
+ *  @file Adafruit_SSD1306.h
+ *  @brief Host mock -- 128x64 framebuffer, display() pushes it over the mocked Wire
+ */
+#pragma once
+#include "Wire.h"
+
+#define SSD1306_BLACK 0
+#define SSD1306_WHITE 1
+#define SSD1306_PAGEADDR 0x22
+#define SSD1306_COLUMNADDR 0x21
+
+class Adafruit_SSD1306 {
+public:
+    Adafruit_SSD1306(uint8_t w, uint8_t h, TwoWire *wire, int8_t rst = -1)
+        : w(w), h(h), wire(wire) { (void)rst; memset(buffer, 0, sizeof(buffer)); }
+
+    uint8_t *getBuffer() { return buffer; }
+    void clearDisplay() { memset(buffer, 0, sizeof(buffer)); }
+
+    void drawPixel(int16_t x, int16_t y, uint16_t color) {
+        if (x < 0 || y < 0 || x >= w || y >= h) return;
+        uint8_t &b = buffer[(y / 8) * w + x];
+        b = color ? (b | (1 << (y & 7))) : (b & ~(1 << (y & 7)));
+    }
+
+    void fillRect(int16_t x, int16_t y, int16_t rw, int16_t rh, uint16_t color) {
+        for (int16_t j = y; j < y + rh; j++)
+            for (int16_t i = x; i < x + rw; i++) drawPixel(i, j, color);
+    }
+
+    void ssd1306_command(uint8_t c) {
+        (void)c;
+        commands++;
+    }
+
+    /** Full framebuffer push, chunked like the library */
+    void display() {
+        for (size_t i = 0; i < (size_t)w * h / 8; i++) {
+            if (i % 31 == 0) {
+                if (i) wire->endTransmission();
+                wire->beginTransmission(0x3C);
+                wire->write((uint8_t)0x40);
+            }
+            wire->write(buffer[i]);
+        }
+        wire->endTransmission();
+    }
+
+    uint32_t commands = 0;
+
+private:
+    int16_t w, h;
+    TwoWire *wire;
+    uint8_t buffer[128 * 64 / 8];
+};
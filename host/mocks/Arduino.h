@@ -0,0 +1,44 @@
+/**
+ *  @file Arduino.h
+ *  @brief Host mock -- the slice of the Arduino core used by the sketch's compute-only headers
+ *
+ *  micros()/millis() run off std::chrono::steady_clock (delay() spins on it); Print writes to stdout.
+ */
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdarg.h>
+#include <string.h>
+#include <math.h>
+#include <chrono>
+
+inline unsigned long micros() {
+    static const auto origin = std::chrono::steady_clock::now();
+    return (unsigned long)std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - origin).count();
+}
+
+inline unsigned long millis() { return micros() / 1000; }
+
+inline void delay(unsigned long ms) {
+    unsigned long start = micros();
+    while (micros() - start < ms * 1000) {}
+}
+
+class Print {
+public:
+    virtual ~Print() {}
+    virtual size_t write(uint8_t c) { return fputc(c, stdout) == EOF ? 0 : 1; }
+    size_t print(const char *s) { return fputs(s, stdout) < 0 ? 0 : strlen(s); }
+    size_t println(const char *s = "") { return printf("%s\n", s); }
+    size_t printf(const char *fmt, ...) __attribute__((format(printf, 2, 3))) {
+        va_list args;
+        va_start(args, fmt);
+        int n = vprintf(fmt, args);
+        va_end(args);
+        return n < 0 ? 0 : n;
+    }
+};
+
+static Print Serial;
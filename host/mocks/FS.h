@@ -0,0 +1,87 @@
+/**
+ *  @file FS.h
+ *  @brief Host mock -- fs::FS / fs::File over an in-memory file table
+ *
+ *  Enough of the ESP32 file system API for FlashLog: open "r" / "w" / "a", seek, read,
+ *  write, size, exists, remove and mkdir. Directories are only remembered by name.
+ *  bytesWritten and writes count what would have reached flash.
+ */
+#pragma once
+#include <stdint.h>
+#include <string.h>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace fs {
+
+class File {
+public:
+    File() {}
+    File(std::vector<uint8_t> *data, bool append, uint32_t *writes, uint32_t *bytes)
+        : data(data), pos(append ? data->size() : 0), writes(writes), bytes(bytes) {}
+
+    explicit operator bool() const { return data != nullptr; }
+
+    size_t write(const uint8_t *buf, size_t len) {
+        if (!data) return 0;
+        if (pos + len > data->size()) data->resize(pos + len);
+        memcpy(data->data() + pos, buf, len);
+        pos += len;
+        (*writes)++;
+        *bytes += len;
+        return len;
+    }
+
+    size_t read(uint8_t *buf, size_t len) {
+        if (!data || pos >= data->size()) return 0;
+        if (len > data->size() - pos) len = data->size() - pos;
+        memcpy(buf, data->data() + pos, len);
+        pos += len;
+        return len;
+    }
+
+    bool seek(uint32_t to) {
+        if (!data || to > data->size()) return false;
+        pos = to;
+        return true;
+    }
+
+    size_t size() const { return data ? data->size() : 0; }
+    void close() { data = nullptr; }
+
+private:
+    std::vector<uint8_t> *data = nullptr;
+    size_t pos = 0;
+    uint32_t *writes = nullptr, *bytes = nullptr;
+};
+
+class FS {
+public:
+    File open(const char *path, const char *mode = "r") {
+        auto it = files.find(path);
+        if (mode[0] == 'r') {
+            return it == files.end() ? File() : File(&it->second, false, &writes, &bytesWritten);
+        }
+        std::vector<uint8_t> &data = files[path];
+        if (mode[0] == 'w') data.clear();
+        return File(&data, mode[0] == 'a', &writes, &bytesWritten);
+    }
+
+    bool exists(const char *path) { return files.count(path) || dirs.count(path); }
+    bool remove(const char *path) { return files.erase(path) > 0; }
+    bool mkdir(const char *path) { dirs.insert(path); return true; }
+    size_t fileCount() const { return files.size(); }
+
+    uint32_t writes = 0, bytesWritten = 0;
+
+private:
+    std::map<std::string, std::vector<uint8_t>> files;
+    std::set<std::string> dirs;
+};
+
+}   // namespace fs
+
+using fs::FS;
+using fs::File;
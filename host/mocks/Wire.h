@@ -0,0 +1,83 @@
+/**
+ *  @file Wire.h
+ *  @brief Host mock -- TwoWire against emulated register-mapped devices
+ *
+ *  Every attached device is a 256-byte register file with an auto-incrementing
+ *  pointer, which is how the BME280 behaves. Writes to unknown addresses are
+ *  accepted and only counted, which is enough for the SSD1306 data stream.
+ */
+#pragma once
+#include "Arduino.h"
+
+struct I2CDevice {
+    uint8_t addr;
+    uint8_t regs[256];
+    uint8_t ptr;
+    I2CDevice *next;
+};
+
+class TwoWire {
+public:
+    void attach(I2CDevice &dev) {
+        dev.ptr = 0;
+        dev.next = devices;
+        devices = &dev;
+    }
+
+    void beginTransmission(uint8_t addr) {
+        target = find(addr);
+        targetAddr = addr;
+        txLen = 0;
+    }
+
+    size_t write(uint8_t b) {
+        if (txLen == 0 && target) {
+            target->ptr = b;            // first byte selects the register
+        } else if (target) {
+            target->regs[target->ptr++] = b;
+        }
+        txLen++;
+        bytesOut++;
+        return 1;
+    }
+
+    uint8_t endTransmission(bool stop = true) {
+        (void)stop;
+        transactions++;
+        return target || targetAddr == unknownOk ? 0 : 2;
+    }
+
+    uint8_t requestFrom(uint8_t addr, uint8_t len, bool stop = true) {
+        (void)stop;
+        I2CDevice *dev = find(addr);
+        if (!dev) return 0;
+        for (uint8_t i = 0; i < len; i++) rx[i] = dev->regs[dev->ptr++];
+        rxLen = len;
+        rxPos = 0;
+        bytesIn += len;
+        return len;
+    }
+
+    int read() { return rxPos < rxLen ? rx[rxPos++] : -1; }
+
+    uint8_t unknownOk = 0x3C;           // write-only device accepted without a register file
+    uint32_t transactions = 0;
+    uint32_t bytesOut = 0, bytesIn = 0;
+
+private:
+    I2CDevice *find(uint8_t addr) {
+        for (I2CDevice *d = devices; d; d = d->next) {
+            if (d->addr == addr) return d;
+        }
+        return nullptr;
+    }
+
+    I2CDevice *devices = nullptr;
+    I2CDevice *target = nullptr;
+    uint8_t targetAddr = 0;
+    uint32_t txLen = 0;
+    uint8_t rx[256];
+    uint16_t rxLen = 0, rxPos = 0;
+};
+
+static TwoWire Wire;